@@ -4,11 +4,32 @@ if not exist lib mkdir lib
 echo Building Library...
 gcc -c src/linear_reg.c -Iinclude -o linear_reg.o
 gcc -c src/logistic_reg.c -Iinclude -o logistic_reg.o
-ar rcs lib/libmllib.a linear_reg.o logistic_reg.o
+gcc -c src/mllib.c -Iinclude -o mllib.o
+gcc -c src/csv_loader.c -Iinclude -o csv_loader.o
+gcc -c src/pipeline.c -Iinclude -o pipeline.o
+gcc -c src/utils.c -Iinclude -o utils.o
+gcc -c src/dataset_view.c -Iinclude -o dataset_view.o
+gcc -c src/distributed.c -Iinclude -o distributed.o
+gcc -c src/thread_pool.c -Iinclude -o thread_pool.o
+gcc -c src/ensemble.c -Iinclude -o ensemble.o
+gcc -c src/coordinate_descent.c -Iinclude -o coordinate_descent.o
+gcc -c src/ml_stats.c -Iinclude -o ml_stats.o
+gcc -c src/block_reduce.c -Iinclude -o block_reduce.o
+gcc -c src/inference_server.c -Iinclude -o inference_server.o
+gcc -c src/step_rule.c -Iinclude -o step_rule.o
+gcc -c src/multi_output.c -Iinclude -o multi_output.o
+gcc -c src/sparse_dataset.c -Iinclude -o sparse_dataset.o
+gcc -c src/feature_scaler.c -Iinclude -o feature_scaler.o
+gcc -c src/ml_numa.c -Iinclude -o ml_numa.o
+gcc -c src/async_train.c -Iinclude -o async_train.o
+ar rcs lib/libmllib.a linear_reg.o logistic_reg.o mllib.o csv_loader.o pipeline.o utils.o dataset_view.o distributed.o thread_pool.o ensemble.o coordinate_descent.o ml_stats.o block_reduce.o inference_server.o step_rule.o multi_output.o sparse_dataset.o feature_scaler.o ml_numa.o async_train.o
 del *.o
 
 echo Building Examples...
-gcc examples/linear_regression_example.c -Iinclude -Llib -lmllib -o examples/linear_regression_example.exe
-gcc examples/logistic_regression_example.c -Iinclude -Llib -lmllib -o examples/logistic_regression_example.exe
+gcc examples/linear_regression_example.c -Iinclude -Llib -lmllib -lpthread -lm -o examples/linear_regression_example.exe
+gcc examples/logistic_regression_example.c -Iinclude -Llib -lmllib -lpthread -lm -o examples/logistic_regression_example.exe
+gcc examples/csv_loader_example.c -Iinclude -Llib -lmllib -lpthread -lm -o examples/csv_loader_example.exe
+gcc examples/inference_server_example.c -Iinclude -Llib -lmllib -lpthread -lm -o examples/inference_server_example.exe
+gcc examples/distributed_example.c -Iinclude -Llib -lmllib -lpthread -lm -o examples/distributed_example.exe
 
 echo Build Complete!
@@ -1,9 +1,87 @@
 #include "csv_loader.h"
 #include "mllib.h"
+#include "multi_output.h"
 #include <stdio.h>
 
+#define WIDE_FEATURES 5
+#define WIDE_TARGETS 60
+#define WIDE_ROWS 200
+
+// Writes a CSV whose lines are far longer than a typical fixed line buffer:
+// target t of each row is (t + 1) * x0 - x1 + 0.1 * t
+static int write_wide_csv(const char *path)
+{
+    FILE *f = fopen(path, "w");
+    if (!f) return -1;
+
+    for (int i = 0; i < WIDE_ROWS; i++)
+    {
+        double x[WIDE_FEATURES];
+
+        for (int j = 0; j < WIDE_FEATURES; j++)
+        {
+            x[j] = ((i * 7 + j * 13) % 23) / 11.0 - 1.0;
+            fprintf(f, "%.6f,", x[j]);
+        }
+
+        for (int t = 0; t < WIDE_TARGETS; t++)
+            fprintf(f, "%.6f%s", (t + 1) * x[0] - x[1] + 0.1 * t, t + 1 < WIDE_TARGETS ? "," : "\n");
+    }
+
+    return fclose(f);
+}
+
+static int wide_multi_target_example(void)
+{
+    const char *path = "wide_targets.csv";
+
+    if (write_wide_csv(path) != 0) {
+        printf("Failed to write %s\n", path);
+        return 1;
+    }
+
+    CsvLoadOptions options = { .num_targets = WIDE_TARGETS };
+    Dataset data = load_csv_ex(path, &options);
+    remove(path);
+
+    if (data.rows == 0) {
+        printf("Failed to load wide dataset\n");
+        return 1;
+    }
+
+    printf("Wide CSV: %zu rows, %zu features, %zu targets\n", data.rows, data.features, data.targets);
+
+    MultiRegressionModel *model = multireg_create(data.features, data.targets);
+    RegressionConfig config = {
+        .learning_rate = 0.1,
+        .num_iterations = 2000,
+    };
+
+    if (!model || multireg_train(model, data.X, data.y, data.rows, &config) != 0) {
+        printf("Multi-target training failed\n");
+        multireg_free(model);
+        free_dataset(&data);
+        return 1;
+    }
+
+    double sample[WIDE_FEATURES] = {0.5, -0.5, 0, 0, 0};
+    double out[WIDE_TARGETS];
+    multireg_predict(model, sample, out);
+
+    // Expected: (t + 1) * 0.5 + 0.5 + 0.1 * t
+    printf("Target 0: %.4f (expected 1.0000), target 59: %.4f (expected 36.4000)\n",
+           out[0], out[WIDE_TARGETS - 1]);
+
+    multireg_free(model);
+    free_dataset(&data);
+    return 0;
+}
+
 int main()
 {
+    if (wide_multi_target_example() != 0)
+        return 1;
+
     Dataset data = load_csv("D:\\Sushrutha\\Projects\\ML model in C\\examples\\so.csv");
 
     if (data.rows == 0) {
@@ -38,4 +116,4 @@ int main()
     free_dataset(&data);
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,161 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <signal.h>
+#include <pthread.h>
+#include "inference_server.h"
+
+#define NUM_SAMPLES 2000
+#define NUM_FEATURES 3
+#define NUM_CLIENTS 16
+#define REQUESTS_PER_CLIENT 2000
+
+static const char *socket_path = "/tmp/mllib_inference_example.sock";
+
+// Client threads check every answer against a direct ml_predict() call
+static MLModel *models[2];
+static const char *model_names[2] = {"price", "churn"};
+
+// y = 1*x0 + 2*x1 + 3*x2 + 0.5
+static void make_data(double *X, double *y, double *labels)
+{
+    srand(42);
+
+    for (int i = 0; i < NUM_SAMPLES; i++)
+    {
+        y[i] = 0.5;
+        for (int j = 0; j < NUM_FEATURES; j++)
+        {
+            X[i * NUM_FEATURES + j] = rand() / (double)RAND_MAX;
+            y[i] += (j + 1) * X[i * NUM_FEATURES + j];
+        }
+        labels[i] = y[i] > 3.5 ? 1.0 : 0.0;
+    }
+}
+
+static void *client_main(void *arg)
+{
+    long id = (long)arg;
+    long mismatches = 0;
+
+    MLClient *client = ml_client_connect(socket_path);
+    if (!client)
+        return (void *)-1L;
+
+    unsigned int seed = (unsigned int)id;
+
+    for (int r = 0; r < REQUESTS_PER_CLIENT; r++)
+    {
+        int m = (r + (int)id) % 2;
+        double x[NUM_FEATURES];
+        double out;
+
+        for (int j = 0; j < NUM_FEATURES; j++)
+            x[j] = rand_r(&seed) / (double)RAND_MAX;
+
+        if (ml_client_predict(client, model_names[m], x, 1, NUM_FEATURES, &out) != 0 ||
+            fabs(out - ml_predict(models[m], x)) > 1e-12)
+            mismatches++;
+    }
+
+    ml_client_close(client);
+    return (void *)mismatches;
+}
+
+static void print_stats(MLServer *server)
+{
+    MLServerStats stats;
+    ml_server_get_stats(server, &stats);
+
+    printf("requests: %zu  rows: %zu  batches: %zu  (%.1f rows/batch)\n",
+           stats.requests, stats.rows, stats.batches, stats.mean_batch_rows);
+    printf("latency p50: %.1f us  p99: %.1f us\n", stats.p50_latency_us, stats.p99_latency_us);
+    printf("throughput: %.0f requests/s over %.2f s\n", stats.requests_per_second, stats.uptime_seconds);
+}
+
+/*
+ * Usage:
+ *   inference_server_example          serve and run a built-in load test
+ *   inference_server_example serve    serve until SIGINT/SIGTERM
+ */
+int main(int argc, char **argv)
+{
+    int daemon_mode = argc > 1 && strcmp(argv[1], "serve") == 0;
+
+    double *X = malloc(NUM_SAMPLES * NUM_FEATURES * sizeof(double));
+    double *y = malloc(NUM_SAMPLES * sizeof(double));
+    double *labels = malloc(NUM_SAMPLES * sizeof(double));
+    if (!X || !y || !labels) return 1;
+
+    make_data(X, y, labels);
+
+    RegressionConfig config = {
+        .learning_rate = 0.1,
+        .num_iterations = 2000,
+        .early_stopping_threshold = 1e-9
+    };
+
+    models[0] = ml_create(ML_LINEAR, NUM_FEATURES);
+    models[1] = ml_create(ML_LOGISTIC, NUM_FEATURES);
+    ml_train(models[0], X, y, NUM_SAMPLES, &config);
+    ml_train(models[1], X, labels, NUM_SAMPLES, &config);
+
+    MLServerConfig server_config = { .max_batch_rows = 256, .max_delay_us = 100 };
+    MLServer *server = ml_server_create(socket_path, &server_config);
+
+    if (!server ||
+        ml_server_register(server, model_names[0], models[0]) != 0 ||
+        ml_server_register(server, model_names[1], models[1]) != 0)
+        return 1;
+
+    if (daemon_mode)
+    {
+        // Block the signals before any thread starts so only sigwait sees them
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &signals, NULL);
+
+        if (ml_server_start(server) != 0) return 1;
+        printf("serving 'price' and 'churn' on %s\n", socket_path);
+        fflush(stdout);
+
+        int sig;
+        sigwait(&signals, &sig);
+    }
+    else
+    {
+        if (ml_server_start(server) != 0) return 1;
+
+        pthread_t clients[NUM_CLIENTS];
+        long mismatches = 0;
+
+        for (long c = 0; c < NUM_CLIENTS; c++)
+            pthread_create(&clients[c], NULL, client_main, (void *)c);
+
+        for (int c = 0; c < NUM_CLIENTS; c++)
+        {
+            void *result;
+            pthread_join(clients[c], &result);
+            mismatches += (long)result;
+        }
+
+        printf("%d clients x %d single-row requests, mismatches: %ld\n",
+               NUM_CLIENTS, REQUESTS_PER_CLIENT, mismatches);
+    }
+
+    ml_server_stop(server);
+    print_stats(server);
+    ml_server_destroy(server);
+
+    ml_destroy(models[0]);
+    ml_destroy(models[1]);
+    free(X);
+    free(y);
+    free(labels);
+    return 0;
+}
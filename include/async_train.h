@@ -0,0 +1,85 @@
+#ifndef ASYNC_TRAIN_H
+#define ASYNC_TRAIN_H
+
+#include <stddef.h>
+#include "mllib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Asynchronous training jobs.
+ *
+ * A job trains one MLModel on a worker of thread_pool_shared(), the same
+ * work-stealing pool the multithreaded gradient passes use. A job with
+ * num_threads > 1 spreads its row blocks over idle workers, and many
+ * small jobs fill the remaining ones, so the total never exceeds one
+ * thread per CPU.
+ *
+ * The model, X, y and any view indices must stay alive and unmodified
+ * until the job has finished; the config is copied.
+ */
+typedef struct MLTrainJob MLTrainJob;
+
+typedef enum
+{
+    ML_JOB_QUEUED = 0,   /**< Waiting for a worker */
+    ML_JOB_RUNNING,      /**< Training */
+    ML_JOB_DONE,         /**< Training returned 0 */
+    ML_JOB_FAILED,       /**< Training returned -1 */
+    ML_JOB_CANCELLED     /**< Cancelled, or stopped by config->should_stop */
+} MLJobStatus;
+
+/**
+ * Queues ml_train(model, x, y, num_samples, config).
+ *
+ * @return Job handle (free with ml_job_free), or NULL on failure
+ */
+MLTrainJob *ml_train_async(MLModel *model,
+                           const double *x,
+                           const double *y,
+                           size_t num_samples,
+                           const RegressionConfig *config);
+
+/**
+ * Queues ml_train_view(model, data, config). The view struct is copied.
+ *
+ * @return Job handle (free with ml_job_free), or NULL on failure
+ */
+MLTrainJob *ml_train_view_async(MLModel *model,
+                                const DatasetView *data,
+                                const RegressionConfig *config);
+
+/**
+ * Returns the current status without blocking.
+ */
+MLJobStatus ml_job_poll(const MLTrainJob *job);
+
+/**
+ * Blocks until the job has finished and returns its final status.
+ *
+ * A job that no worker has picked up yet runs on the calling thread, so
+ * waiting from inside a pool task cannot deadlock.
+ */
+MLJobStatus ml_job_wait(MLTrainJob *job);
+
+/**
+ * Requests cancellation. A queued job never starts; a running one stops
+ * at its next iteration, leaving the model untrained (unless training
+ * completes first).
+ *
+ * @return 0 if the job had not finished yet, -1 if it had
+ */
+int ml_job_cancel(MLTrainJob *job);
+
+/**
+ * Waits for the job to finish and frees the handle.
+ */
+void ml_job_free(MLTrainJob *job);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ASYNC_TRAIN_H */
@@ -0,0 +1,83 @@
+#ifndef BLOCK_REDUCE_H
+#define BLOCK_REDUCE_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Rows per block in reproducible mode. Fixed so that the reduction tree
+ * depends only on the number of rows, never on the thread count.
+ */
+#define ML_REDUCE_BLOCK_ROWS 1024
+
+/**
+ * Accumulates the partial sums of rows [begin, end) into partial
+ * (already zeroed, width doubles).
+ */
+typedef void (*BlockKernel)(void *ctx, size_t begin, size_t end, double *partial);
+
+/**
+ * Multithreaded sum over rows with an optional bit-reproducible mode.
+ *
+ * In reproducible mode every ML_REDUCE_BLOCK_ROWS block is summed in row
+ * order into its own slot and the slots are combined by a fixed pairwise
+ * tree, so the result is identical for any thread count. Blocks are
+ * summed in waves of bounded scratch and each subtree of the tree is
+ * merged as soon as both halves exist, so memory grows with the log of
+ * the row count rather than with it. Otherwise each
+ * thread sums one contiguous range and the ranges are added in order,
+ * which is slightly cheaper but depends on the thread count. With one
+ * thread and reproducible mode off, the kernel runs once over all rows,
+ * exactly like the original serial loop.
+ *
+ * In NUMA mode the rows are split over the NUMA nodes as ml_numa_split()
+ * does, and each node's rows are summed by workers pinned to that node.
+ * The plain sum is reduced hierarchically: the chunks of a node are
+ * added on that node, then the per-node partials are added in node
+ * order. Reproducible mode keeps its single block tree, so its result
+ * is unchanged.
+ */
+typedef struct BlockReducer BlockReducer;
+
+/**
+ * Creates a reducer for num_rows rows and partial sums of up to max_width
+ * doubles. Scratch space is allocated once and reused by every run.
+ *
+ * @param num_threads     Threads to use, counting the caller (0 or 1 = serial)
+ * @param reproducible    Non-zero for the fixed block/tree reduction
+ * @param numa            Non-zero to group rows and threads by NUMA node (ignored
+ *                        on single-node machines and for serial runs). Every node
+ *                        gets at least one thread.
+ *
+ * @return Pointer to BlockReducer, or NULL on failure
+ */
+BlockReducer *block_reducer_create(size_t num_rows,
+                                   size_t max_width,
+                                   size_t num_threads,
+                                   int reproducible,
+                                   int numa);
+
+/**
+ * Computes result[0..width) = sum of kernel partials over all rows.
+ *
+ * @return 0 on success, -1 on failure
+ */
+int block_reducer_run(BlockReducer *reducer,
+                      size_t width,
+                      BlockKernel kernel,
+                      void *ctx,
+                      double *result);
+
+/**
+ * Frees the reducer.
+ */
+void block_reducer_free(BlockReducer *reducer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLOCK_REDUCE_H */
@@ -0,0 +1,103 @@
+#ifndef COORDINATE_DESCENT_H
+#define COORDINATE_DESCENT_H
+
+#include <stddef.h>
+#include "linear_reg.h"
+#include "logistic_reg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Fits penalized linear regression by cyclic coordinate descent.
+ *
+ * Minimizes (1/2n) sum (y - Xw - b)^2 + l1 * |w|_1 + l2/2 * |w|^2.
+ * A residual vector is kept up to date after each coordinate change, so
+ * each coordinate costs one pass over its column. After a full sweep,
+ * further sweeps visit only the active (non-zero) coefficients until they
+ * settle; a final full sweep confirms that no other coefficient enters.
+ *
+ * The current weights are the starting point (warm start).
+ * config->num_iterations bounds the number of sweeps and
+ * config->early_stopping_threshold is the tolerance on the largest
+ * coefficient change in a sweep. Called by linreg_train() when
+ * config->solver is REG_SOLVER_CD.
+ *
+ * @param model Pointer to model.
+ * @param data View over the training rows.
+ * @param config Training configuration.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int linreg_train_cd(RegressionModel *model,
+                    const DatasetView *data,
+                    const RegressionConfig *config);
+
+/**
+ * @brief Fits penalized logistic regression by cyclic coordinate descent.
+ *
+ * Minimizes mean binary cross entropy + l1 * |w|_1 + l2/2 * |w|^2. Each
+ * coordinate takes a majorized Newton step (curvature bounded by 1/4), so
+ * the objective never increases. Logits and probabilities are updated
+ * only for rows where the feature is non-zero. Active sets, warm start
+ * and stopping rules are the same as for linreg_train_cd().
+ *
+ * @param model Pointer to model.
+ * @param data View over the training rows (y values 0 or 1).
+ * @param config Training configuration.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int logreg_train_cd(RegressionModel *model,
+                    const DatasetView *data,
+                    const RegressionConfig *config);
+
+/**
+ * @brief Fits a regularization path, warm-starting each fit from the last.
+ *
+ * For each k, trains with config->l1_penalty replaced by l1_path[k]
+ * (best given in decreasing order) and stores the weights followed by
+ * the bias in out[k * (num_features + 1)]. The model is left at the last
+ * solution. Any solver may be used, but coordinate descent benefits most.
+ *
+ * @param model Pointer to model (linear or logistic, matching type).
+ * @param data View over the training rows.
+ * @param config Training configuration.
+ * @param l1_path L1 penalties along the path.
+ * @param path_length Number of penalties.
+ * @param out Output, path_length x (num_features + 1).
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int linreg_fit_path(RegressionModel *model,
+                    const DatasetView *data,
+                    const RegressionConfig *config,
+                    const double *l1_path,
+                    size_t path_length,
+                    double *out);
+
+/** @brief Logistic counterpart of linreg_fit_path(). */
+int logreg_fit_path(RegressionModel *model,
+                    const DatasetView *data,
+                    const RegressionConfig *config,
+                    const double *l1_path,
+                    size_t path_length,
+                    double *out);
+
+/**
+ * @brief Smallest L1 penalty at which every weight is zero.
+ *
+ * max_j |x_j . (y - mean(y))| / n, the usual starting point of a path.
+ * The same value applies to logistic regression with y in {0, 1}.
+ *
+ * @param data View over the training rows.
+ * @return The penalty, or 0 if data is empty.
+ */
+double lasso_lambda_max(const DatasetView *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COORDINATE_DESCENT_H */
@@ -3,27 +3,78 @@
 
 #include <stdbool.h>
 #include <stdio.h>
+#include <stddef.h>
+#include "dataset_view.h"
+#include "sparse_dataset.h"
+#include "feature_scaler.h"
 
 // Struct to hold dataset
 typedef struct {
-    double *X;
-    double *y;
-    int rows;
-    int cols;
-    int features;
+    double *X;        // rows x stride, 64-byte aligned
+    double *y;        // rows x targets, row-major
+    size_t rows;
+    size_t cols;
+    size_t features;
+    size_t stride;    // doubles per row of X (> features when rows are padded)
+    size_t targets;   // target columns per row of y (1 unless num_targets was set)
+    FeatureScaler *scaler; // per-feature mean/variance when compute_scaler was set, else NULL
 } Dataset;
 
+// Optional loader settings; a NULL pointer or zeroed struct gives the defaults
+typedef struct {
+    bool pad_rows;    // pad each row of X to a multiple of the SIMD width (zero-filled)
+    bool huge_pages;  // request explicit huge pages for X/y (falls back to transparent ones)
+    size_t num_targets; // trailing columns read as targets (0 = 1)
+    bool compute_scaler; // accumulate feature statistics while parsing (see RegressionConfig.standardize)
+    bool numa;        // place the row blocks of X/y on the NUMA nodes that train on them (see RegressionConfig.numa)
+} CsvLoadOptions;
+
 // Utility
 bool check_file_extension(const char *filename);
 bool is_number(const char *str);
 
 // Core API
 bool has_header(FILE *f);
-int count_columns(FILE *f, bool header);
-int count_rows(FILE *f, bool header);
+size_t count_columns(FILE *f, bool header);
+size_t count_rows(FILE *f, bool header);
 
 // Main function (important)
 Dataset load_csv(const char *filename);
+Dataset load_csv_ex(const char *filename, const CsvLoadOptions *options);
+
+// Settings for load_csv_hashed; a NULL pointer or zeroed struct gives the defaults
+typedef struct {
+    unsigned int hash_bits; // feature space has 2^hash_bits columns (0 = 18, max 31)
+    bool signed_hash;       // multiply each value by a hash-derived +-1 so collisions cancel on average
+} CsvHashOptions;
+
+// Loads a CSV with categorical columns into a sparse, feature-hashed dataset.
+// Every column but the last is hashed together with its header name (or
+// position): numeric fields become hash(column) = value, any other field
+// becomes hash(column=value) = 1, and empty fields are skipped. The last
+// column is the numeric target, so the first line is taken as a header when
+// its last field is not a number; later rows without a numeric target are
+// skipped and counted in skipped_rows. Lines may be of any length. Rows are parsed
+// in one pass and the dense one-hot matrix is never built. Returns a zeroed
+// dataset on failure.
+SparseDataset load_csv_hashed(const char *filename, const CsvHashOptions *options);
+
+// Streaming reader: parses a CSV incrementally, one block of rows at a time
+typedef struct {
+    FILE *f;
+    size_t cols;
+    size_t features;
+    char *line;             // line buffer, grown to the longest line read
+    size_t line_capacity;
+} CsvReader;
+
+bool csv_reader_open(CsvReader *reader, const char *filename);
+size_t csv_read_block(CsvReader *reader, double *X, double *y, size_t max_rows);
+void csv_reader_close(CsvReader *reader);
+
+// Zero-copy view over all rows of a loaded dataset (honours row padding).
+// Multi-target datasets get a NULL y; pass data->y to multireg_train_view.
+DatasetView dataset_view(const Dataset *data);
 
 // Helper
 void free_dataset(Dataset *data);
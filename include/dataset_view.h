@@ -0,0 +1,102 @@
+#ifndef DATASET_VIEW_H
+#define DATASET_VIEW_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Non-owning view over a row-major feature matrix and target vector.
+ *
+ * A view selects rows of an existing X/y without copying them. Row i of
+ * the view is base row rows[i] when an index array is present, otherwise
+ * base row i. Shuffles, splits and bootstrap samples therefore cost
+ * O(rows) in indices instead of O(rows * features) in copied doubles.
+ */
+typedef struct DatasetView
+{
+    const double *X;      /**< Base of the feature matrix */
+    const double *y;      /**< Base of the target vector (may be NULL for prediction) */
+    const size_t *rows;   /**< Optional base-row indices (NULL = rows 0..num_rows-1) */
+    size_t num_rows;      /**< Number of rows visible through the view */
+    size_t num_features;  /**< Number of features per row */
+    size_t row_stride;    /**< Doubles between consecutive base rows of X */
+    int owns_rows;        /**< Set when rows was allocated by a view_* function */
+} DatasetView;
+
+/**
+ * @brief Returns the base-row index of view row i.
+ */
+static inline size_t view_base_row(const DatasetView *v, size_t i)
+{
+    return v->rows ? v->rows[i] : i;
+}
+
+/**
+ * @brief Returns a pointer to the features of view row i.
+ */
+static inline const double *view_row(const DatasetView *v, size_t i)
+{
+    return v->X + view_base_row(v, i) * v->row_stride;
+}
+
+/**
+ * @brief Returns the target of view row i.
+ */
+static inline double view_target(const DatasetView *v, size_t i)
+{
+    return v->y[view_base_row(v, i)];
+}
+
+/**
+ * @brief Creates a view over contiguous arrays (row_stride = num_features).
+ */
+DatasetView view_create(const double *X,
+                        const double *y,
+                        size_t num_rows,
+                        size_t num_features);
+
+/**
+ * @brief Creates a view of base with its rows in a random order.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int view_shuffle(const DatasetView *base, unsigned int seed, DatasetView *out);
+
+/**
+ * @brief Splits base into shuffled, disjoint train and test views.
+ *
+ * @param test_fraction Fraction of rows placed in the test view, in [0, 1].
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int view_train_test_split(const DatasetView *base,
+                          double test_fraction,
+                          unsigned int seed,
+                          DatasetView *train,
+                          DatasetView *test);
+
+/**
+ * @brief Creates a bootstrap sample of base (num_rows draws with replacement).
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int view_bootstrap(const DatasetView *base,
+                   size_t num_rows,
+                   unsigned int seed,
+                   DatasetView *out);
+
+/**
+ * @brief Frees the index array of a view created by a view_* function.
+ *
+ * The underlying X/y are never freed.
+ */
+void view_release(DatasetView *view);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DATASET_VIEW_H */
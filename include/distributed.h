@@ -0,0 +1,89 @@
+#ifndef DISTRIBUTED_H
+#define DISTRIBUTED_H
+
+#include <stddef.h>
+#include "mllib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Communication channel between the processes of a data-parallel job.
+ *
+ * A transport is a small v-table: allreduce() sums a buffer across all
+ * ranks in place, destroy() releases it. Custom transports can be plugged
+ * in by filling the struct directly. The built-in transports combine
+ * contributions in rank order, so every rank sees bit-identical sums.
+ */
+typedef struct MLTransport MLTransport;
+
+struct MLTransport
+{
+    int rank;         /* This process's rank, 0 .. world_size-1 */
+    int world_size;   /* Number of participating processes */
+    int (*allreduce)(MLTransport *t, double *buf, size_t count);
+    void (*destroy)(MLTransport *t);
+    void *impl;       /* Transport-specific state */
+};
+
+/**
+ * Creates a transport over a POSIX shared-memory segment.
+ *
+ * Rank 0 creates the segment; other ranks wait for it to appear.
+ * All processes must run on the same host.
+ *
+ * @param name        Segment name, e.g. "/mllib_job42"
+ * @param rank        Rank of the calling process
+ * @param world_size  Number of processes
+ *
+ * @return Transport on success, NULL on failure
+ */
+MLTransport *ml_transport_shm_create(const char *name, int rank, int world_size);
+
+/**
+ * Creates a transport over Unix-domain or TCP sockets.
+ *
+ * Rank 0 listens on the address and the other ranks connect to it.
+ * Doubles are sent in native byte order, so every rank must share the
+ * same architecture.
+ *
+ * @param address     "unix:/path/to/socket" or "tcp:host:port"
+ * @param rank        Rank of the calling process
+ * @param world_size  Number of processes
+ *
+ * @return Transport on success, NULL on failure
+ */
+MLTransport *ml_transport_socket_create(const char *address, int rank, int world_size);
+
+/**
+ * Destroys a transport.
+ *
+ * @param t   Transport (may be NULL)
+ */
+void ml_transport_destroy(MLTransport *t);
+
+/**
+ * Trains a model data-parallel across all ranks of a transport.
+ *
+ * Each process passes its own shard and an identically created model and
+ * config; gradients and losses are allreduced every iteration, so every
+ * rank finishes with the same weights.
+ *
+ * @param model       Pointer to MLModel
+ * @param shard       View over this process's rows
+ * @param config      Pointer to RegressionConfig
+ * @param transport   Transport shared by all ranks
+ *
+ * @return 0 on success, -1 on failure
+ */
+int ml_train_distributed(MLModel *model,
+                         const DatasetView *shard,
+                         const RegressionConfig *config,
+                         MLTransport *transport);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DISTRIBUTED_H */
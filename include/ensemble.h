@@ -0,0 +1,95 @@
+#ifndef ENSEMBLE_H
+#define ENSEMBLE_H
+
+#include <stddef.h>
+#include "mllib.h"
+#include "thread_pool.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Opaque bagging ensemble of linear or logistic models.
+ */
+typedef struct MLEnsemble MLEnsemble;
+
+/**
+ * Creates an ensemble of untrained members.
+ *
+ * @param type          ML_LINEAR or ML_LOGISTIC
+ * @param num_features  Number of input features
+ * @param num_members   Number of bootstrap members
+ *
+ * @return Pointer to MLEnsemble on success, NULL on failure
+ */
+MLEnsemble *ml_ensemble_create(MLModelType type,
+                               size_t num_features,
+                               size_t num_members);
+
+/**
+ * Trains every member on its own bootstrap sample of data.
+ *
+ * Members train concurrently on pool. Bootstrap samples are row-index
+ * views over the shared X/y, so no rows are copied. Member m samples with
+ * a seed derived from seed and m, so results do not depend on the pool.
+ *
+ * @param ensemble      Pointer to MLEnsemble
+ * @param data          View over the training rows
+ * @param config        Pointer to RegressionConfig (shared by all members)
+ * @param seed          Bootstrap seed
+ * @param pool          Thread pool, or NULL for the shared pool
+ *
+ * @return 0 if every member trained, -1 otherwise
+ */
+int ml_ensemble_train(MLEnsemble *ensemble,
+                      const DatasetView *data,
+                      const RegressionConfig *config,
+                      unsigned int seed,
+                      ThreadPool *pool);
+
+/**
+ * Scores every member on every row in a single pass over each row.
+ *
+ * @param ensemble      Trained MLEnsemble
+ * @param data          View over the rows to score
+ * @param out           Output, data->num_rows x num_members, row-major
+ *
+ * @return 0 on success, -1 on failure
+ */
+int ml_ensemble_predict_batch(const MLEnsemble *ensemble,
+                              const DatasetView *data,
+                              double *out);
+
+/**
+ * Mean and variance of the member predictions for every row.
+ *
+ * @param ensemble      Trained MLEnsemble
+ * @param data          View over the rows to score
+ * @param mean          Output of size data->num_rows
+ * @param variance      Output of size data->num_rows (may be NULL)
+ *
+ * @return 0 on success, -1 on failure
+ */
+int ml_ensemble_predict_mean(const MLEnsemble *ensemble,
+                             const DatasetView *data,
+                             double *mean,
+                             double *variance);
+
+/**
+ * Returns the number of members.
+ */
+size_t ml_ensemble_size(const MLEnsemble *ensemble);
+
+/**
+ * Destroys the ensemble and frees memory.
+ *
+ * @param ensemble   Pointer to MLEnsemble
+ */
+void ml_ensemble_destroy(MLEnsemble *ensemble);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ENSEMBLE_H */
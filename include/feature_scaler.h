@@ -0,0 +1,87 @@
+#ifndef FEATURE_SCALER_H
+#define FEATURE_SCALER_H
+
+#include <stddef.h>
+#include "dataset_view.h"
+#include "reducer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Running per-feature mean and variance (Welford's algorithm).
+ *
+ * Used to train on standardized features, (x - mean) / std, without
+ * copying X: see RegressionConfig.standardize.
+ */
+typedef struct FeatureScaler
+{
+    size_t num_features;  /**< Number of features */
+    size_t count;         /**< Rows accumulated so far */
+    double *mean;         /**< Running mean per feature */
+    double *m2;           /**< Sum of squared deviations from the mean per feature */
+} FeatureScaler;
+
+/**
+ * @brief Creates an empty scaler.
+ *
+ * @return Pointer to FeatureScaler, or NULL on failure.
+ */
+FeatureScaler *scaler_create(size_t num_features);
+
+/**
+ * @brief Adds one row (num_features doubles) to the statistics.
+ */
+void scaler_update(FeatureScaler *scaler, const double *row);
+
+/**
+ * @brief Adds every row of a view in one pass.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int scaler_fit_view(FeatureScaler *scaler, const DatasetView *data);
+
+/**
+ * @brief Combines the statistics of all workers of a data-parallel job
+ * (Chan et al. merge, expressed as two sum-allreduces).
+ *
+ * Every worker must call it. A worker whose local fit failed passes a
+ * NULL scaler and still takes part; a leading one-value reduction then
+ * makes all workers return -1.
+ *
+ * @return 0 on success, -1 on failure (on every worker).
+ */
+int scaler_merge_reduced(FeatureScaler *scaler, const GradientReducer *reducer);
+
+/**
+ * @brief Returns the statistics a trainer should standardize with: given
+ * when it is non-NULL, otherwise a new scaler fitted over data (and merged
+ * across workers when reducer is non-NULL), which is also stored in *owned
+ * for the caller to free.
+ *
+ * With a reducer, a local failure is reported on every worker.
+ *
+ * @return Scaler to use, or NULL on failure.
+ */
+const FeatureScaler *scaler_resolve(const FeatureScaler *given,
+                                    const DatasetView *data,
+                                    const GradientReducer *reducer,
+                                    FeatureScaler **owned);
+
+/**
+ * @brief Returns 1 / standard deviation of feature j, or 1 for a constant
+ * feature.
+ */
+double scaler_inv_std(const FeatureScaler *scaler, size_t j);
+
+/**
+ * @brief Frees the scaler.
+ */
+void scaler_free(FeatureScaler *scaler);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FEATURE_SCALER_H */
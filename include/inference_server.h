@@ -0,0 +1,156 @@
+#ifndef INFERENCE_SERVER_H
+#define INFERENCE_SERVER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "mllib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Local batched inference server.
+ *
+ * A server holds a registry of named MLModels and answers predict requests
+ * over a Unix domain socket. Requests from all connections go into one
+ * queue. A batcher thread coalesces them into micro-batches and scores
+ * every model's share with a single ml_predict_view() call. A batch is
+ * dispatched once it holds max_batch_rows rows, or once its oldest request
+ * has waited max_delay_us.
+ *
+ * Wire format (native byte order, one request in flight per connection):
+ *   request:  MLServeRequestHeader, model name (name_len bytes),
+ *             num_rows * num_features doubles
+ *   response: MLServeResponseHeader, num_rows doubles (if status == 0)
+ *
+ * A request for an unknown model, with the wrong feature count or with a
+ * payload over ML_SERVE_MAX_REQUEST_BYTES gets an error response before
+ * its payload is read, and the connection is then closed.
+ */
+
+#define ML_SERVE_MAGIC 0x524C4D4Du            /* "MLMR" */
+#define ML_SERVE_MAX_NAME 64                  /* Including the terminator */
+#define ML_SERVE_MAX_REQUEST_ROWS 65536
+#define ML_SERVE_MAX_REQUEST_BYTES ((size_t)64 << 20)  /* Feature payload of one request */
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t name_len;
+    uint32_t num_rows;
+    uint32_t num_features;
+} MLServeRequestHeader;
+
+typedef struct
+{
+    uint32_t magic;
+    int32_t status;       /* 0 on success, -1 on bad request or unknown model */
+    uint32_t num_rows;
+    uint32_t reserved;
+} MLServeResponseHeader;
+
+/**
+ * Batching parameters. Zero fields take the defaults in brackets.
+ */
+typedef struct
+{
+    size_t max_batch_rows;       /**< Dispatch once this many rows are queued [1024] */
+    unsigned int max_delay_us;   /**< Latency budget for the oldest queued request [200] */
+} MLServerConfig;
+
+/**
+ * Snapshot of server counters. Latency is measured from the moment a
+ * request has been fully read until its response has been written. The
+ * percentiles cover the most recent 65536 requests.
+ */
+typedef struct
+{
+    size_t requests;
+    size_t rows;
+    size_t batches;
+    double mean_batch_rows;
+    double p50_latency_us;
+    double p99_latency_us;
+    double uptime_seconds;
+    double requests_per_second;
+    double rows_per_second;
+} MLServerStats;
+
+typedef struct MLServer MLServer;
+typedef struct MLClient MLClient;
+
+/**
+ * Creates a server that will listen on socket_path.
+ *
+ * @param socket_path  Filesystem path of the Unix socket
+ * @param config       Batching parameters, or NULL for the defaults
+ *
+ * @return Pointer to MLServer, or NULL on failure
+ */
+MLServer *ml_server_create(const char *socket_path, const MLServerConfig *config);
+
+/**
+ * Adds a model to the registry under name. The server does not take
+ * ownership; the model must stay alive until ml_server_destroy().
+ * Models must be registered before ml_server_start().
+ *
+ * @return 0 on success, -1 on failure (duplicate name, server running, ...)
+ */
+int ml_server_register(MLServer *server, const char *name, const MLModel *model);
+
+/**
+ * Binds the socket and starts the accept and batcher threads.
+ *
+ * @return 0 on success, -1 on failure
+ */
+int ml_server_start(MLServer *server);
+
+/**
+ * Stops accepting requests, finishes queued ones and joins all threads.
+ */
+void ml_server_stop(MLServer *server);
+
+/**
+ * Fills stats with the current counters.
+ *
+ * @return 0 on success, -1 on failure
+ */
+int ml_server_get_stats(MLServer *server, MLServerStats *stats);
+
+/**
+ * Stops the server if needed, removes the socket file and frees memory.
+ */
+void ml_server_destroy(MLServer *server);
+
+/**
+ * Connects to a running server.
+ *
+ * @return Pointer to MLClient, or NULL on failure
+ */
+MLClient *ml_client_connect(const char *socket_path);
+
+/**
+ * Scores num_rows rows of x (row-major) with the named model.
+ *
+ * @param out   Output array of size num_rows
+ *
+ * @return 0 on success, -1 on failure
+ */
+int ml_client_predict(MLClient *client,
+                      const char *model,
+                      const double *x,
+                      size_t num_rows,
+                      size_t num_features,
+                      double *out);
+
+/**
+ * Closes the connection and frees the client.
+ */
+void ml_client_close(MLClient *client);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INFERENCE_SERVER_H */
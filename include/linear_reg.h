@@ -2,6 +2,8 @@
 #define LINEAR_REG_H
 
 #include <stddef.h>
+#include "dataset_view.h"
+#include "reducer.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -23,6 +25,26 @@ typedef struct RegressionModel
     int trained;              /**< Flag indicating if model is trained */
 } RegressionModel;
 
+/**
+ * @brief Optimization algorithm used by the trainers.
+ */
+typedef enum RegressionSolver
+{
+    REG_SOLVER_GD = 0,   /**< Batch (proximal) gradient descent */
+    REG_SOLVER_CD        /**< Cyclic coordinate descent with active sets */
+} RegressionSolver;
+
+/**
+ * @brief Step-size strategy for gradient descent.
+ */
+typedef enum RegressionStepRule
+{
+    REG_STEP_FIXED = 0,  /**< Constant learning_rate */
+    REG_STEP_ARMIJO,     /**< Backtracking line search on the loss, starting from learning_rate */
+    REG_STEP_BB,         /**< Barzilai-Borwein steps; learning_rate is the first step */
+    REG_STEP_NESTEROV    /**< Nesterov momentum with adaptive restart, step learning_rate */
+} RegressionStepRule;
+
 /**
  * @brief Configuration parameters for training.
  *
@@ -34,9 +56,43 @@ typedef struct RegressionConfig
     double learning_rate;          /**< Gradient descent step size */
     size_t num_iterations;         /**< Maximum number of iterations */
     double early_stopping_threshold; /**< Relative loss improvement threshold */
+    size_t loss_sample_size;       /**< Rows in the fixed random loss subsample (0 = all rows) */
+    unsigned int loss_sample_seed; /**< Seed used to draw the loss subsample */
+    size_t loss_check_interval;    /**< Evaluate the loss every N iterations (0 or 1 = every iteration) */
+    size_t patience;               /**< Consecutive non-improving checks before stopping (0 = 1) */
+    double l1_penalty;             /**< Lasso penalty l1 * sum|w| (bias is not penalized) */
+    double l2_penalty;             /**< Ridge penalty l2/2 * sum w^2 (bias is not penalized) */
+    RegressionSolver solver;       /**< Optimization algorithm */
+    size_t num_threads;            /**< Gradient/loss threads, counting the caller (0 or 1 = serial) */
+    int reproducible;              /**< Non-zero for bitwise-identical sums at any thread count */
+    RegressionStepRule step_rule;  /**< Step-size strategy for gradient descent */
+    int standardize;               /**< Non-zero to run gradient descent on (x - mean) / std; weights stay in raw units */
+    const struct FeatureScaler *scaler; /**< Statistics for standardize, or NULL to fit them on the training rows */
+    int numa;                      /**< Non-zero to split gradient threads by NUMA node, pinned, with per-node sums */
+    int (*should_stop)(void *ctx); /**< Polled once per iteration; non-zero aborts training with -1 on every worker (NULL = never) */
+    void *stop_ctx;                /**< Argument passed to should_stop */
 } RegressionConfig;
 #endif
 
+/**
+ * @brief Sufficient statistics of a dataset for squared loss.
+ *
+ * The gradient and loss of linear regression depend on the data only
+ * through these sums, so once accumulated each gradient-descent iteration
+ * costs O(num_features^2) instead of O(num_samples * num_features).
+ * Statistics of separate shards can be merged with linreg_stats_merge().
+ */
+typedef struct LinRegStats
+{
+    size_t num_features;  /**< Number of input features */
+    size_t num_samples;   /**< Number of rows accumulated so far */
+    double *xtx;          /**< X^T X, num_features x num_features, row-major */
+    double *xty;          /**< X^T y, size num_features */
+    double *x_sum;        /**< Column sums of X, size num_features */
+    double y_sum;         /**< Sum of y */
+    double yty;           /**< y^T y */
+} LinRegStats;
+
 /**
  * @brief Creates a linear regression model.
  *
@@ -62,6 +118,102 @@ int linreg_train(RegressionModel *model,
                   size_t num_samples,
                   const RegressionConfig *config);
 
+/**
+ * @brief Trains the model on the rows selected by a dataset view.
+ *
+ * Same algorithm as linreg_train(); shuffled, split or bootstrapped views
+ * are read in place without copying X.
+ *
+ * @param model Pointer to model.
+ * @param data View over the training rows (y required).
+ * @param config Training configuration.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int linreg_train_view(RegressionModel *model,
+                      const DatasetView *data,
+                      const RegressionConfig *config);
+
+/**
+ * @brief Trains on one shard, summing gradients with other workers each iteration.
+ *
+ * Same as linreg_train_view(), except that every partial sum (gradient, bias
+ * gradient, loss and row counts) passes through reducer before use, so all
+ * workers apply identical updates. A NULL reducer trains locally.
+ *
+ * Failures are agreed on through the same reductions: if any worker fails
+ * (allocation, an empty total), all of them return -1 at the same point.
+ *
+ * @param model Pointer to model (identically initialized on every worker).
+ * @param data View over this worker's rows (may be empty).
+ * @param config Training configuration (identical on every worker).
+ * @param reducer Sum-allreduce hook, or NULL.
+ *
+ * @return 0 on success, -1 on failure (on every worker).
+ */
+int linreg_train_reduced(RegressionModel *model,
+                         const DatasetView *data,
+                         const RegressionConfig *config,
+                         const GradientReducer *reducer);
+
+/**
+ * @brief Allocates zeroed sufficient statistics.
+ *
+ * @param num_features Number of input features.
+ * @return Pointer to allocated LinRegStats or NULL on failure.
+ */
+LinRegStats* linreg_stats_create(size_t num_features);
+
+/**
+ * @brief Adds a block of rows to the statistics in a single pass.
+ *
+ * May be called repeatedly as data arrives.
+ *
+ * @param stats Statistics to update.
+ * @param X Flattened feature matrix (size: num_samples * num_features).
+ * @param y Target vector (size: num_samples).
+ * @param num_samples Number of rows in this block.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int linreg_stats_accumulate(LinRegStats *stats,
+                            const double *X,
+                            const double *y,
+                            size_t num_samples);
+
+/**
+ * @brief Merges the statistics of another shard into dst.
+ *
+ * @param dst Statistics to update.
+ * @param src Statistics of a disjoint set of rows (same num_features).
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int linreg_stats_merge(LinRegStats *dst, const LinRegStats *src);
+
+/**
+ * @brief Trains the model by gradient descent on sufficient statistics.
+ *
+ * Follows the same update rule and early-stopping criterion as
+ * linreg_train(), without rescanning the data.
+ *
+ * @param model Pointer to model.
+ * @param stats Accumulated statistics (at least 2 samples).
+ * @param config Training configuration.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int linreg_train_stats(RegressionModel *model,
+                       const LinRegStats *stats,
+                       const RegressionConfig *config);
+
+/**
+ * @brief Frees sufficient statistics.
+ *
+ * @param stats Pointer to statistics.
+ */
+void linreg_stats_free(LinRegStats *stats);
+
 /**
  * @brief Predicts output for a single sample.
  *
@@ -72,6 +224,18 @@ int linreg_train(RegressionModel *model,
 double linreg_predict(RegressionModel *model,
                       const double *x);
 
+/**
+ * @brief Predicts outputs for every row of a dataset view.
+ *
+ * @param model Trained model.
+ * @param data View over the rows to score (y unused).
+ * @param out Output array (size: data->num_rows).
+ * @return 0 on success, -1 on failure.
+ */
+int linreg_predict_view(const RegressionModel *model,
+                        const DatasetView *data,
+                        double *out);
+
 /**
  * @brief Frees model memory.
  *
@@ -2,6 +2,9 @@
 #define LOGISTIC_REG_H
 
 #include <stddef.h>
+#include <stdint.h>
+#include "dataset_view.h"
+#include "reducer.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -23,6 +26,26 @@ typedef struct RegressionModel
     int trained;                /**< Flag indicating if model is trained */
 } RegressionModel;
 
+/**
+ * @brief Optimization algorithm used by the trainers.
+ */
+typedef enum RegressionSolver
+{
+    REG_SOLVER_GD = 0,   /**< Batch (proximal) gradient descent */
+    REG_SOLVER_CD        /**< Cyclic coordinate descent with active sets */
+} RegressionSolver;
+
+/**
+ * @brief Step-size strategy for gradient descent.
+ */
+typedef enum RegressionStepRule
+{
+    REG_STEP_FIXED = 0,  /**< Constant learning_rate */
+    REG_STEP_ARMIJO,     /**< Backtracking line search on the loss, starting from learning_rate */
+    REG_STEP_BB,         /**< Barzilai-Borwein steps; learning_rate is the first step */
+    REG_STEP_NESTEROV    /**< Nesterov momentum with adaptive restart, step learning_rate */
+} RegressionStepRule;
+
 /**
  * @brief Configuration parameters for logistic regression training.
  */
@@ -31,6 +54,21 @@ typedef struct RegressionConfig
     double learning_rate;           /**< Gradient descent step size */
     size_t num_iterations;          /**< Maximum number of iterations */
     double early_stopping_threshold;/**< Relative loss improvement threshold */
+    size_t loss_sample_size;       /**< Rows in the fixed random loss subsample (0 = all rows) */
+    unsigned int loss_sample_seed; /**< Seed used to draw the loss subsample */
+    size_t loss_check_interval;    /**< Evaluate the loss every N iterations (0 or 1 = every iteration) */
+    size_t patience;               /**< Consecutive non-improving checks before stopping (0 = 1) */
+    double l1_penalty;             /**< Lasso penalty l1 * sum|w| (bias is not penalized) */
+    double l2_penalty;             /**< Ridge penalty l2/2 * sum w^2 (bias is not penalized) */
+    RegressionSolver solver;       /**< Optimization algorithm */
+    size_t num_threads;            /**< Gradient/loss threads, counting the caller (0 or 1 = serial) */
+    int reproducible;              /**< Non-zero for bitwise-identical sums at any thread count */
+    RegressionStepRule step_rule;  /**< Step-size strategy for gradient descent */
+    int standardize;               /**< Non-zero to run gradient descent on (x - mean) / std; weights stay in raw units */
+    const struct FeatureScaler *scaler; /**< Statistics for standardize, or NULL to fit them on the training rows */
+    int numa;                      /**< Non-zero to split gradient threads by NUMA node, pinned, with per-node sums */
+    int (*should_stop)(void *ctx); /**< Polled once per iteration; non-zero aborts training with -1 on every worker (NULL = never) */
+    void *stop_ctx;                /**< Argument passed to should_stop */
 } RegressionConfig;
 #endif
 
@@ -66,6 +104,57 @@ int logreg_train(RegressionModel *model,
                  size_t num_samples,
                  const RegressionConfig *config);
 
+/**
+ * @brief Trains the model on the rows selected by a dataset view.
+ *
+ * Same algorithm as logreg_train(), reading rows in place through the view.
+ *
+ * @param model Pointer to model.
+ * @param data View over the training rows (y required, values 0 or 1).
+ * @param config Training configuration parameters.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int logreg_train_view(RegressionModel *model,
+                      const DatasetView *data,
+                      const RegressionConfig *config);
+
+/**
+ * @brief Trains on one shard, summing gradients with other workers each iteration.
+ *
+ * Same as logreg_train_view(), except that every partial sum (gradient, bias
+ * gradient, loss and row counts) passes through reducer before use, so all
+ * workers apply identical updates. A NULL reducer trains locally.
+ *
+ * Failures are agreed on through the same reductions: if any worker fails
+ * (allocation, an empty total), all of them return -1 at the same point.
+ *
+ * @param model Pointer to model (identically initialized on every worker).
+ * @param data View over this worker's rows (may be empty).
+ * @param config Training configuration (identical on every worker).
+ * @param reducer Sum-allreduce hook, or NULL.
+ *
+ * @return 0 on success, -1 on failure (on every worker).
+ */
+int logreg_train_reduced(RegressionModel *model,
+                         const DatasetView *data,
+                         const RegressionConfig *config,
+                         const GradientReducer *reducer);
+
+/**
+ * @brief Numerically stable logistic function 1 / (1 + exp(-z)).
+ *
+ * @param z Logit.
+ * @return Probability in range [0,1].
+ */
+double sigmoid(double z);
+
+/**
+ * @brief Cross entropy of probability p against label y, with p clamped
+ * away from 0 and 1.
+ */
+double binary_cross_entropy(double p, double y);
+
 /**
  * @brief Predicts probability for a single sample.
  *
@@ -76,6 +165,67 @@ int logreg_train(RegressionModel *model,
 double logreg_predict(const RegressionModel *model,
                             const double *x);
 
+/**
+ * @brief Predicts probabilities for every row of a dataset view.
+ *
+ * @param model Trained model.
+ * @param data View over the rows to score (y unused).
+ * @param out Output array (size: data->num_rows).
+ * @return 0 on success, -1 on failure.
+ */
+int logreg_predict_view(const RegressionModel *model,
+                        const DatasetView *data,
+                        double *out);
+
+/**
+ * @brief Converts a probability threshold to the logit threshold used by
+ * logreg_classify(): log(t / (1 - t)).
+ *
+ * Compute it once and reuse it; 0.5 maps to 0. Thresholds <= 0 give
+ * -INFINITY (every row positive) and > 1 give +INFINITY (none). A
+ * threshold of exactly 1 gives the smallest logit whose sigmoid rounds
+ * to 1.0, so the decision still matches logreg_predict() >= 1.
+ *
+ * @param threshold Probability threshold.
+ * @return Logit threshold.
+ */
+double logreg_logit_threshold(double threshold);
+
+/**
+ * @brief Class decision for a single sample, without evaluating the sigmoid.
+ *
+ * Returns 1 when the logit w.x + b is at least logit_threshold, which is
+ * the same as logreg_predict(model, x) >= threshold.
+ *
+ * @param model Trained model.
+ * @param x Feature vector (size: num_features).
+ * @param logit_threshold Value from logreg_logit_threshold().
+ * @return 1 or 0, or -1 if x is NULL or the model is not trained.
+ */
+int logreg_classify(const RegressionModel *model,
+                    const double *x,
+                    double logit_threshold);
+
+/**
+ * @brief Class decisions for every row of a dataset view, as a bitmask.
+ *
+ * Bit (i % 64) of mask[i / 64] is set when row i is positive; unused
+ * bits of the last word are cleared. Callers can skip all-zero words, and
+ * a zero positive count means no row needs further work.
+ *
+ * @param model Trained model.
+ * @param data View over the rows to classify (y unused).
+ * @param logit_threshold Value from logreg_logit_threshold().
+ * @param mask Output of (data->num_rows + 63) / 64 words.
+ * @param num_positive Optional output: number of positive rows.
+ * @return 0 on success, -1 on failure.
+ */
+int logreg_classify_view(const RegressionModel *model,
+                         const DatasetView *data,
+                         double logit_threshold,
+                         uint64_t *mask,
+                         size_t *num_positive);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,70 @@
+#ifndef ML_NUMA_H
+#define ML_NUMA_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Largest number of NUMA nodes the library uses. Further nodes get no
+ * pinned workers and no rows.
+ */
+#define ML_NUMA_MAX_NODES 64
+
+/**
+ * Returns the number of NUMA nodes that have CPUs (1 on non-NUMA
+ * machines and on platforms without topology information).
+ *
+ * Nodes are numbered 0..count-1 by this library, in the order the OS
+ * lists them, whatever their OS node ids are.
+ */
+size_t ml_numa_num_nodes(void);
+
+/**
+ * Returns the number of online CPUs on node (0 for an unknown node).
+ */
+size_t ml_numa_node_cpus(size_t node);
+
+/**
+ * Restricts the calling thread to the CPUs of node.
+ *
+ * @return 0 on success, -1 if pinning is unsupported or failed
+ */
+int ml_numa_pin_current(size_t node);
+
+/**
+ * Row range [*begin, *end) of num_rows owned by node when rows are split
+ * over num_nodes nodes.
+ *
+ * Ranges are contiguous, in node order, and start on multiples of
+ * ML_REDUCE_BLOCK_ROWS, so the loader's placement and the trainer's work
+ * split agree row for row.
+ */
+void ml_numa_split(size_t num_rows, size_t num_nodes, size_t node,
+                   size_t *begin, size_t *end);
+
+/**
+ * Places the pages of a row-major array on the nodes that own its rows
+ * (see ml_numa_split). Call before the array is first written, and only
+ * on memory that owns its pages (ml_aligned_is_mapped), since the policy
+ * applies to whole pages.
+ *
+ * Each node's range is bound with a preferred-node memory policy; where
+ * that is unavailable, a thread pinned to the node touches the range
+ * first instead (the array is zero-filled).
+ *
+ * @param base        Start of the array
+ * @param row_bytes   Bytes per row
+ * @param num_rows    Number of rows
+ *
+ * @return 0 on success, -1 on failure (the array is still usable)
+ */
+int ml_numa_place(void *base, size_t row_bytes, size_t num_rows);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ML_NUMA_H */
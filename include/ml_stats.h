@@ -0,0 +1,133 @@
+#ifndef ML_STATS_H
+#define ML_STATS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Snapshot of the library's profiling counters.
+ *
+ * Counters are only collected when the library is compiled with
+ * -DML_ENABLE_STATS; otherwise every field reads as zero and the
+ * instrumentation compiles to nothing. Counters are process-wide and
+ * updated atomically, so concurrent training calls are summed.
+ */
+typedef struct MLStats
+{
+    /* load_csv / CSV reader */
+    double load_seconds;        /* Wall time spent loading */
+    uint64_t bytes_parsed;      /* Bytes of CSV text parsed */
+    uint64_t rows_parsed;       /* Data rows parsed */
+
+    /* linreg / logreg training */
+    double train_seconds;       /* Wall time inside train calls */
+    uint64_t train_calls;       /* Number of train calls */
+    uint64_t iterations;        /* Iterations (or CD sweeps) run */
+    uint64_t rows_processed;    /* Rows visited by gradient passes */
+    double gradient_seconds;    /* Time in gradient passes */
+    double loss_seconds;        /* Time evaluating the early-stopping loss */
+    double update_seconds;      /* Time applying weight updates */
+
+    /* prediction */
+    double predict_seconds;     /* Wall time inside predict calls */
+    uint64_t predict_calls;     /* Single-row and batch predict calls */
+    uint64_t rows_predicted;    /* Rows scored */
+
+    /* hardware counters (Linux perf_event_open, training only; calling
+       thread only, so work done by pool workers is not counted) */
+    int hw_counters;            /* 1 if any hardware counts were collected */
+    uint64_t cycles;            /* CPU cycles */
+    uint64_t instructions;      /* Retired instructions */
+    uint64_t cache_misses;      /* Last-level cache misses */
+} MLStats;
+
+/**
+ * Copies the current counters into out.
+ *
+ * @param out   Destination snapshot
+ */
+void ml_stats_get(MLStats *out);
+
+/**
+ * Resets every counter to zero.
+ */
+void ml_stats_reset(void);
+
+/**
+ * Enables or disables hardware counters for subsequent train calls.
+ *
+ * The counters are opened for the thread that calls the train function.
+ * Pool workers already exist by then and are not inherited, so with
+ * num_threads > 1 the counts cover only the caller's share of the work.
+ *
+ * @param enable   Non-zero to enable
+ *
+ * @return 0 on success, -1 if unavailable (not Linux, or stats compiled out)
+ */
+int ml_stats_enable_hw_counters(int enable);
+
+/*
+ * Instrumentation used inside the library
+ */
+typedef enum
+{
+    ML_STAT_LOAD_NS,
+    ML_STAT_BYTES_PARSED,
+    ML_STAT_ROWS_PARSED,
+    ML_STAT_TRAIN_NS,
+    ML_STAT_TRAIN_CALLS,
+    ML_STAT_ITERATIONS,
+    ML_STAT_ROWS_PROCESSED,
+    ML_STAT_GRADIENT_NS,
+    ML_STAT_LOSS_NS,
+    ML_STAT_UPDATE_NS,
+    ML_STAT_PREDICT_NS,
+    ML_STAT_PREDICT_CALLS,
+    ML_STAT_ROWS_PREDICTED,
+    ML_STAT_HW_CYCLES,
+    ML_STAT_HW_INSTRUCTIONS,
+    ML_STAT_HW_CACHE_MISSES,
+    ML_STAT_COUNT
+} MLStatCounter;
+
+/* Per-call hardware counter handles */
+typedef struct
+{
+    int fds[3];
+} MLHwCounters;
+
+#ifdef ML_ENABLE_STATS
+
+uint64_t ml_stats_clock_ns(void);
+void ml_stats_add(MLStatCounter counter, uint64_t value);
+void ml_stats_hw_begin(MLHwCounters *hw);
+void ml_stats_hw_end(MLHwCounters *hw);
+
+#define ML_STATS_START(t)           uint64_t t = ml_stats_clock_ns()
+#define ML_STATS_STOP(counter, t)   ml_stats_add((counter), ml_stats_clock_ns() - (t))
+#define ML_STATS_COUNT(counter, n)  ml_stats_add((counter), (uint64_t)(n))
+#define ML_STATS_HW_BEGIN(hw)       MLHwCounters hw; ml_stats_hw_begin(&hw)
+#define ML_STATS_HW_END(hw)         ml_stats_hw_end(&hw)
+#define ML_STATS_TALLY(t)           uint64_t t = 0
+#define ML_STATS_TALLY_ADD(t, n)    ((t) += (uint64_t)(n))
+
+#else
+
+#define ML_STATS_START(t)           ((void)0)
+#define ML_STATS_STOP(counter, t)   ((void)0)
+#define ML_STATS_COUNT(counter, n)  ((void)0)
+#define ML_STATS_HW_BEGIN(hw)       ((void)0)
+#define ML_STATS_HW_END(hw)         ((void)0)
+#define ML_STATS_TALLY(t)           ((void)0)
+#define ML_STATS_TALLY_ADD(t, n)    ((void)0)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ML_STATS_H */
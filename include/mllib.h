@@ -8,6 +8,7 @@ extern "C" {
 #include <stddef.h>
 #include "linear_reg.h"
 #include "logistic_reg.h"
+#include "sparse_dataset.h"
 
 
 /* Forward declaration of RegressionConfig */
@@ -55,6 +56,35 @@ int ml_train(MLModel *model,
              size_t num_samples,
              const RegressionConfig *config);
 
+/**
+ * Trains the given model on the rows selected by a dataset view.
+ *
+ * @param model         Pointer to MLModel
+ * @param data          View over the training rows
+ * @param config        Pointer to RegressionConfig
+ *
+ * @return 0 on success, -1 on failure
+ */
+int ml_train_view(MLModel *model,
+                  const DatasetView *data,
+                  const RegressionConfig *config);
+
+/**
+ * Trains on one data shard, summing gradients with other workers through
+ * reducer every iteration (see linreg_train_reduced()).
+ *
+ * @param model         Pointer to MLModel
+ * @param data          View over this worker's rows
+ * @param config        Pointer to RegressionConfig
+ * @param reducer       Sum-allreduce hook, or NULL to train locally
+ *
+ * @return 0 on success, -1 on failure
+ */
+int ml_train_reduced(MLModel *model,
+                     const DatasetView *data,
+                     const RegressionConfig *config,
+                     const GradientReducer *reducer);
+
 /**
  * Predicts output using trained model.
  *
@@ -66,6 +96,88 @@ int ml_train(MLModel *model,
 double ml_predict(const MLModel *model,
                   const double *x);
 
+/**
+ * Predicts outputs for every row of a dataset view.
+ *
+ * @param model   Pointer to MLModel
+ * @param data    View over the rows to score
+ * @param out     Output array of size data->num_rows
+ *
+ * @return 0 on success, -1 on failure
+ */
+int ml_predict_view(const MLModel *model,
+                    const DatasetView *data,
+                    double *out);
+
+/**
+ * Class decision for one sample of a logistic model, without the sigmoid.
+ *
+ * @param model             Pointer to MLModel (ML_LOGISTIC)
+ * @param x                 Feature vector for single sample
+ * @param logit_threshold   Value from logreg_logit_threshold()
+ *
+ * @return 1 or 0, or -1 on failure
+ */
+int ml_classify(const MLModel *model,
+                const double *x,
+                double logit_threshold);
+
+/**
+ * Class decisions for every row of a dataset view as a bitmask
+ * (see logreg_classify_view()).
+ *
+ * @param model             Pointer to MLModel (ML_LOGISTIC)
+ * @param data              View over the rows to classify
+ * @param logit_threshold   Value from logreg_logit_threshold()
+ * @param mask              Output of (data->num_rows + 63) / 64 words
+ * @param num_positive      Optional output: number of positive rows
+ *
+ * @return 0 on success, -1 on failure
+ */
+int ml_classify_view(const MLModel *model,
+                     const DatasetView *data,
+                     double logit_threshold,
+                     uint64_t *mask,
+                     size_t *num_positive);
+
+/**
+ * Trains the model on a sparse (e.g. feature-hashed) dataset.
+ * The model must have data->num_features features.
+ *
+ * @param model   Pointer to MLModel
+ * @param data    Sparse training rows
+ * @param config  Pointer to RegressionConfig
+ *
+ * @return 0 on success, -1 on failure
+ */
+int ml_train_sparse(MLModel *model,
+                    const SparseDataset *data,
+                    const RegressionConfig *config);
+
+/**
+ * Predicts output for one sparse row.
+ *
+ * @param model   Pointer to MLModel
+ * @param idx     Feature indices of the non-zeros
+ * @param val     Values of the non-zeros
+ * @param nnz     Number of non-zeros
+ *
+ * @return Prediction value (linear output or logistic probability), NAN on failure
+ */
+double ml_predict_sparse(const MLModel *model,
+                         const uint32_t *idx,
+                         const double *val,
+                         size_t nnz);
+
+/**
+ * Returns the number of input features the model expects.
+ *
+ * @param model   Pointer to MLModel
+ *
+ * @return Feature count, or 0 if model is NULL
+ */
+size_t ml_num_features(const MLModel *model);
+
 /**
  * Destroys the model and frees memory.
  *
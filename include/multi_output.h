@@ -0,0 +1,104 @@
+#ifndef MULTI_OUTPUT_H
+#define MULTI_OUTPUT_H
+
+#include <stddef.h>
+#include "linear_reg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Linear regression with several targets sharing the same features.
+ *
+ * Prediction for target t is bias[t] + sum_j x[j] * weights[j * num_targets + t].
+ * All targets are fitted together, so each iteration streams X once
+ * regardless of num_targets.
+ */
+typedef struct MultiRegressionModel
+{
+    size_t num_features;      /**< Number of input features */
+    size_t num_targets;       /**< Number of outputs */
+    double *weights;          /**< num_features x num_targets, row-major */
+    double *bias;             /**< Bias per target, size num_targets */
+    size_t stopping_iteration;/**< Iteration where training stopped */
+    int trained;              /**< Flag indicating if model is trained */
+} MultiRegressionModel;
+
+/**
+ * @brief Creates a zero-initialized multi-output model.
+ *
+ * @return Pointer to model, or NULL on failure.
+ */
+MultiRegressionModel *multireg_create(size_t num_features, size_t num_targets);
+
+/**
+ * @brief Trains by batch gradient descent on the squared error summed
+ * over targets and averaged over rows.
+ *
+ * Gradients are divided by the row count only, so each target's weights
+ * and bias take the same steps as a separate linreg_train() on that target
+ * would. The data term of the loss used for early stopping is additionally
+ * divided by the number of targets.
+ *
+ * Rows are processed in small tiles: the residuals of a tile (tile x T)
+ * are formed from X_tile * W, then X_tile^T * E is added to the gradient,
+ * so W and the gradient are reused across the rows of the tile. The loss
+ * falls out of the same pass, so loss_sample_size is not used.
+ * learning_rate, num_iterations, early stopping, penalties, num_threads
+ * and reproducible behave as in linreg_train(); only the fixed step rule
+ * and the gradient-descent solver are supported.
+ *
+ * @param model Pointer to model.
+ * @param X Flattened feature matrix (row-major, num_samples x num_features).
+ * @param Y Flattened target matrix (row-major, num_samples x num_targets).
+ * @param num_samples Number of rows.
+ * @param config Training configuration.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int multireg_train(MultiRegressionModel *model,
+                   const double *X,
+                   const double *Y,
+                   size_t num_samples,
+                   const RegressionConfig *config);
+
+/**
+ * @brief Trains on the rows selected by a view. Row i of the view uses
+ * targets Y[view_base_row(data, i) * num_targets ...]; data->y is ignored.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int multireg_train_view(MultiRegressionModel *model,
+                        const DatasetView *data,
+                        const double *Y,
+                        const RegressionConfig *config);
+
+/**
+ * @brief Predicts all targets for one sample.
+ *
+ * @param out Output array of size num_targets.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int multireg_predict(const MultiRegressionModel *model, const double *x, double *out);
+
+/**
+ * @brief Predicts all targets for every row of a view.
+ *
+ * @param out Output, data->num_rows x num_targets, row-major.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int multireg_predict_view(const MultiRegressionModel *model, const DatasetView *data, double *out);
+
+/**
+ * @brief Frees the model.
+ */
+void multireg_free(MultiRegressionModel *model);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MULTI_OUTPUT_H */
@@ -0,0 +1,45 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stddef.h>
+#include "mllib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Trains a model while the CSV file is still being parsed.
+ *
+ * A producer thread parses the next block of rows into one half of a
+ * double buffer while the calling thread runs gradient descent on the
+ * block in the other half. The first pass over the file therefore costs
+ * roughly max(parse time, train time) instead of their sum.
+ *
+ * Each block gets steps_per_block gradient steps, starting from the
+ * weights the previous block left behind; config->num_iterations is not
+ * used. The other settings (step rule, penalties, early stopping) apply
+ * within each block. If a single row is left at the end of the file, it
+ * is added to the last full block rather than trained on its own.
+ * config->standardize is rejected: a scaler refit on every block would
+ * change the scale the earlier weights were learnt in.
+ *
+ * @param model            Pointer to MLModel (feature count must match the file)
+ * @param filename         Path to a .csv file (last column is the target)
+ * @param block_rows       Number of rows parsed per block (at least 2)
+ * @param steps_per_block  Gradient steps taken on each block (at least 1)
+ * @param config           Pointer to RegressionConfig
+ *
+ * @return 0 on success, -1 on failure (including a file with no data rows)
+ */
+int ml_train_pipelined(MLModel *model,
+                       const char *filename,
+                       size_t block_rows,
+                       size_t steps_per_block,
+                       const RegressionConfig *config);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PIPELINE_H */
@@ -0,0 +1,27 @@
+#ifndef REDUCER_H
+#define REDUCER_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Hook through which a trainer combines partial sums with other workers.
+ *
+ * allreduce() must replace buf with the element-wise sum of buf over all
+ * participants and return 0, or return -1 on failure. Every participant
+ * calls it the same number of times with the same count.
+ */
+typedef struct GradientReducer
+{
+    int (*allreduce)(void *ctx, double *buf, size_t count); /**< Sum-allreduce in place */
+    void *ctx;                                              /**< Passed to allreduce */
+} GradientReducer;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* REDUCER_H */
@@ -0,0 +1,66 @@
+#ifndef SPARSE_DATASET_H
+#define SPARSE_DATASET_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "linear_reg.h"
+#include "logistic_reg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Feature matrix in compressed sparse row (CSR) form.
+ *
+ * The non-zeros of row i are col_idx/values[row_ptr[i] .. row_ptr[i+1]),
+ * with column indices sorted and unique within a row.
+ */
+typedef struct SparseDataset
+{
+    size_t rows;          /**< Number of rows */
+    size_t num_features;  /**< Width of the feature space */
+    size_t nnz;           /**< Stored non-zeros */
+    size_t *row_ptr;      /**< Row offsets, size rows + 1 */
+    uint32_t *col_idx;    /**< Column of each non-zero */
+    double *values;       /**< Value of each non-zero */
+    double *y;            /**< Target per row */
+    size_t skipped_rows;  /**< Rows load_csv_hashed dropped for a missing or non-numeric target */
+} SparseDataset;
+
+/**
+ * @brief Returns b + w . x for a sparse row.
+ */
+double sparse_dot(const RegressionModel *model, const uint32_t *idx, const double *val, size_t nnz);
+
+/**
+ * @brief Trains a linear model whose num_features equals data->num_features.
+ *
+ * Full-batch gradient descent that touches only the stored non-zeros of
+ * each row, so a pass costs O(nnz + num_features). learning_rate,
+ * num_iterations, early stopping (interval and patience) and the L1/L2
+ * penalties behave as in linreg_train(); the loss is taken from the
+ * gradient pass. Any other solver or step rule, num_threads > 1,
+ * reproducible, numa, loss_sample_size or standardize is rejected.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int linreg_train_sparse(RegressionModel *model, const SparseDataset *data, const RegressionConfig *config);
+
+/**
+ * @brief Trains a logistic model on sparse rows (see linreg_train_sparse()).
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int logreg_train_sparse(RegressionModel *model, const SparseDataset *data, const RegressionConfig *config);
+
+/**
+ * @brief Frees the arrays of a sparse dataset.
+ */
+void free_sparse_dataset(SparseDataset *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPARSE_DATASET_H */
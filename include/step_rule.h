@@ -0,0 +1,78 @@
+#ifndef STEP_RULE_H
+#define STEP_RULE_H
+
+#include <stddef.h>
+#include "linear_reg.h"
+#include "logistic_reg.h"
+#include "feature_scaler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Returns the mean (unpenalized) loss at the model's current
+ * parameters, or NAN on failure. Used by the Armijo line search.
+ */
+typedef double (*StepLossFn)(void *ctx);
+
+/**
+ * @brief Step-size state shared by the gradient-descent trainers.
+ *
+ * Implements the config->step_rule strategies on top of one proximal
+ * gradient step (plain step, then apply_penalty_step()). The gradient is
+ * passed as d+1 sums (dw followed by db).
+ */
+typedef struct StepRule StepRule;
+
+/**
+ * @brief Creates step-size state for a model with num_features weights.
+ * The current model parameters are the starting point.
+ *
+ * With a scaler, the rule optimizes the weights of the standardized
+ * features (x - mean) / std and after every step folds them back into
+ * model->weights/bias. The model therefore always predicts on raw
+ * features, and the gradient kernels never see scaled data.
+ *
+ * @param scaler  Feature statistics, or NULL to optimize raw weights
+ *
+ * @return Pointer to StepRule, or NULL on failure.
+ */
+StepRule *step_rule_create(const RegressionModel *model, const RegressionConfig *config,
+                           const FeatureScaler *scaler);
+
+/**
+ * @brief Takes one step.
+ *
+ * grad is divided by scale in place (giving the mean gradient), then the
+ * model is moved according to the rule. loss_fn is only called by
+ * REG_STEP_ARMIJO and may be NULL otherwise.
+ *
+ * @return 0 on success, -1 if loss_fn failed.
+ */
+int step_rule_update(StepRule *rule, RegressionModel *model, double *grad, double scale,
+                     StepLossFn loss_fn, void *ctx);
+
+/**
+ * @brief Returns the L1/L2 penalty of the optimized (possibly
+ * standardized) weights.
+ */
+double step_rule_penalty(StepRule *rule, RegressionModel *model);
+
+/**
+ * @brief Leaves the final iterate in the model. Nesterov momentum
+ * evaluates gradients at an extrapolated point, which is what the model
+ * holds between updates.
+ */
+void step_rule_finish(StepRule *rule, RegressionModel *model);
+
+/**
+ * @brief Frees the state.
+ */
+void step_rule_free(StepRule *rule);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STEP_RULE_H */
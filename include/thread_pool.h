@@ -0,0 +1,112 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Opaque pool of worker threads shared by the parallel parts of the library.
+ *
+ * Each worker owns a deque: tasks submitted from a worker go to the back
+ * of its own deque and run newest-first, idle workers steal from the
+ * front of the others', and tasks from outside the pool go through a
+ * shared queue. Nested parallel work (a training job whose gradient pass
+ * calls thread_pool_parallel_for) therefore spreads over idle workers
+ * instead of adding threads.
+ */
+typedef struct ThreadPool ThreadPool;
+
+/**
+ * Creates a thread pool.
+ *
+ * @param num_threads   Number of workers (0 = number of online CPUs)
+ *
+ * @return Pointer to ThreadPool on success, NULL on failure
+ */
+ThreadPool *thread_pool_create(size_t num_threads);
+
+/**
+ * Returns the process-wide pool, creating it on first use.
+ *
+ * The shared pool has one worker per online CPU and is never destroyed.
+ *
+ * @return Pointer to ThreadPool, or NULL if it could not be created
+ */
+ThreadPool *thread_pool_shared(void);
+
+/**
+ * Returns the pool whose workers are pinned to the CPUs of NUMA node
+ * (see ml_numa.h), creating it on first use.
+ *
+ * Node pools have one worker per CPU of the node and are never destroyed.
+ *
+ * @return Pointer to ThreadPool, or NULL for an unknown node or on failure
+ */
+ThreadPool *thread_pool_node(size_t node);
+
+/**
+ * Returns the number of worker threads.
+ */
+size_t thread_pool_size(const ThreadPool *pool);
+
+/**
+ * Queues fn(arg) to run on a worker thread.
+ *
+ * @return 0 on success, -1 on failure
+ */
+int thread_pool_submit(ThreadPool *pool, void (*fn)(void *arg), void *arg);
+
+/**
+ * Runs fn(ctx, i) for every i in [0, count) and waits for completion.
+ *
+ * The calling thread takes part in the work, so it is safe to call from
+ * inside a task running on the same pool.
+ *
+ * @return 0 on success, -1 on failure
+ */
+int thread_pool_parallel_for(ThreadPool *pool,
+                             size_t count,
+                             void (*fn)(void *ctx, size_t index),
+                             void *ctx);
+
+/**
+ * Like thread_pool_parallel_for(), but runs on at most max_threads
+ * threads, counting the caller.
+ *
+ * @return 0 on success, -1 on failure
+ */
+int thread_pool_parallel_for_limit(ThreadPool *pool,
+                                   size_t count,
+                                   size_t max_threads,
+                                   void (*fn)(void *ctx, size_t index),
+                                   void *ctx);
+
+/**
+ * Runs fn(ctx, node) for every node in [0, num_nodes), each on a worker
+ * of thread_pool_node(node), and waits for completion.
+ *
+ * fn may call thread_pool_parallel_for() on its node's pool to spread
+ * work over the node's CPUs. The caller only waits, unless a node has no
+ * pool, in which case it runs that node's call itself.
+ *
+ * @return 0 on success, -1 on failure
+ */
+int thread_pool_run_on_nodes(size_t num_nodes,
+                             void (*fn)(void *ctx, size_t node),
+                             void *ctx);
+
+/**
+ * Waits for queued tasks to finish and joins the workers.
+ *
+ * Must not be called on the shared pool.
+ */
+void thread_pool_destroy(ThreadPool *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* THREAD_POOL_H */
@@ -3,8 +3,48 @@
 
 #include <string.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 bool has_file_extension(const char *filename, const char *ext);
 
+// Alignment of large numeric buffers (one cache line / AVX-512 vector)
+#define ML_ALIGNMENT 64
 
-#endif
\ No newline at end of file
+// Buffers at least this large are page-mapped and eligible for huge pages
+#define ML_HUGE_PAGE_SIZE ((size_t)2 << 20)
+
+// Flags for ml_aligned_alloc
+#define ML_ALLOC_HUGE_PAGES 1   // request explicit huge pages (falls back silently)
+
+// Allocates ML_ALIGNMENT-aligned memory. Large blocks are page-mapped with
+// transparent huge pages where the OS supports them. Free with ml_aligned_free.
+void *ml_aligned_alloc(size_t bytes, int flags);
+void ml_aligned_free(void *ptr);
+
+// True when an ml_aligned_alloc block is a private page mapping rather than
+// heap memory, so page-level calls (madvise, mbind) cannot touch other data
+bool ml_aligned_is_mapped(const void *ptr);
+
+// Seeded pseudo-random generator shared by the sampling helpers
+uint64_t random_init(unsigned int seed);
+uint64_t random_next(uint64_t *state);
+
+// Draws k distinct row indices from [0, n) (all rows if k >= n), sorted
+// ascending. Deterministic for a given seed. Caller frees the result.
+size_t *sample_indices(size_t n, size_t k, unsigned int seed);
+
+// True when the loss should be evaluated on this iteration
+bool is_loss_check(size_t iter, size_t interval);
+
+// sign(x) * max(|x| - t, 0), the proximal operator of t*|x|
+double soft_threshold(double x, double t);
+
+// l1 * sum|w| + l2/2 * sum w^2
+double penalty_value(const double *w, size_t n, double l1, double l2);
+
+// Applies one proximal gradient step of the penalties to w in place,
+// after the plain loss gradient step has been taken
+void apply_penalty_step(double *w, size_t n, double step, double l1, double l2);
+
+#endif
@@ -0,0 +1,185 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "async_train.h"
+#include "thread_pool.h"
+
+struct MLTrainJob
+{
+    MLModel *model;
+    DatasetView data;          // copy; the rows stay owned by the caller
+    RegressionConfig config;   // copy, with should_stop pointing at the job
+    int (*user_stop)(void *ctx);
+    void *user_stop_ctx;
+    atomic_int status;         // MLJobStatus
+    atomic_int cancel;
+    atomic_int stopped;        // training was ended by cancel or user_stop
+    atomic_int refs;           // caller handle + queued pool task
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+};
+
+static int job_should_stop(void *ctx)
+{
+    MLTrainJob *job = ctx;
+
+    if (atomic_load(&job->cancel) ||
+        (job->user_stop && job->user_stop(job->user_stop_ctx)))
+    {
+        atomic_store(&job->stopped, 1);
+        return 1;
+    }
+
+    return 0;
+}
+
+static void job_release(MLTrainJob *job)
+{
+    if (atomic_fetch_sub(&job->refs, 1) == 1)
+    {
+        pthread_mutex_destroy(&job->lock);
+        pthread_cond_destroy(&job->cond);
+        free(job);
+    }
+}
+
+static void job_finish(MLTrainJob *job, MLJobStatus status)
+{
+    pthread_mutex_lock(&job->lock);
+    atomic_store(&job->status, status);
+    pthread_cond_broadcast(&job->cond);
+    pthread_mutex_unlock(&job->lock);
+}
+
+// Runs the job unless another thread already claimed or cancelled it
+static void job_run(MLTrainJob *job)
+{
+    int expected = ML_JOB_QUEUED;
+
+    if (!atomic_compare_exchange_strong(&job->status, &expected, ML_JOB_RUNNING))
+        return;
+
+    int rc = ml_train_view(job->model, &job->data, &job->config);
+
+    if (rc == 0)
+        job_finish(job, ML_JOB_DONE);
+    else
+        job_finish(job, atomic_load(&job->stopped) ? ML_JOB_CANCELLED : ML_JOB_FAILED);
+}
+
+static void job_task(void *arg)
+{
+    MLTrainJob *job = arg;
+
+    job_run(job);
+    job_release(job);
+}
+
+MLTrainJob *ml_train_view_async(MLModel *model,
+                                const DatasetView *data,
+                                const RegressionConfig *config)
+{
+    if (!model || !data || !config)
+    {
+        fprintf(stderr, "Null pointer passed to ml_train_view_async.\n");
+        return NULL;
+    }
+
+    ThreadPool *pool = thread_pool_shared();
+    if (!pool)
+        return NULL;
+
+    MLTrainJob *job = malloc(sizeof(MLTrainJob));
+    if (!job)
+        return NULL;
+
+    job->model = model;
+    job->data = *data;
+    job->config = *config;
+    job->user_stop = config->should_stop;
+    job->user_stop_ctx = config->stop_ctx;
+    job->config.should_stop = job_should_stop;
+    job->config.stop_ctx = job;
+    atomic_init(&job->status, ML_JOB_QUEUED);
+    atomic_init(&job->cancel, 0);
+    atomic_init(&job->stopped, 0);
+    atomic_init(&job->refs, 2);
+    pthread_mutex_init(&job->lock, NULL);
+    pthread_cond_init(&job->cond, NULL);
+
+    if (thread_pool_submit(pool, job_task, job) != 0)
+    {
+        atomic_store(&job->refs, 1);
+        job_release(job);
+        return NULL;
+    }
+
+    return job;
+}
+
+MLTrainJob *ml_train_async(MLModel *model,
+                           const double *x,
+                           const double *y,
+                           size_t num_samples,
+                           const RegressionConfig *config)
+{
+    if (!model || !x || !y)
+    {
+        fprintf(stderr, "Null pointer passed to ml_train_async.\n");
+        return NULL;
+    }
+
+    DatasetView data = view_create(x, y, num_samples, ml_num_features(model));
+    return ml_train_view_async(model, &data, config);
+}
+
+MLJobStatus ml_job_poll(const MLTrainJob *job)
+{
+    if (!job)
+        return ML_JOB_FAILED;
+
+    return (MLJobStatus)atomic_load(&((MLTrainJob *)job)->status);
+}
+
+MLJobStatus ml_job_wait(MLTrainJob *job)
+{
+    if (!job)
+        return ML_JOB_FAILED;
+
+    // Still queued: do the work here instead of blocking a thread
+    job_run(job);
+
+    pthread_mutex_lock(&job->lock);
+    while (atomic_load(&job->status) <= ML_JOB_RUNNING)
+        pthread_cond_wait(&job->cond, &job->lock);
+    pthread_mutex_unlock(&job->lock);
+
+    return (MLJobStatus)atomic_load(&job->status);
+}
+
+int ml_job_cancel(MLTrainJob *job)
+{
+    if (!job)
+        return -1;
+
+    atomic_store(&job->cancel, 1);
+
+    int expected = ML_JOB_QUEUED;
+    if (atomic_compare_exchange_strong(&job->status, &expected, ML_JOB_RUNNING))
+    {
+        job_finish(job, ML_JOB_CANCELLED);
+        return 0;
+    }
+
+    return expected == ML_JOB_RUNNING ? 0 : -1;
+}
+
+void ml_job_free(MLTrainJob *job)
+{
+    if (!job)
+        return;
+
+    ml_job_wait(job);
+    job_release(job);
+}
@@ -0,0 +1,377 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "block_reduce.h"
+#include "thread_pool.h"
+#include "ml_numa.h"
+
+// Reproducible mode sums at most this much of block partials at a time
+#define REDUCE_SCRATCH_BYTES ((size_t)64 << 20)
+
+struct BlockReducer
+{
+    size_t num_rows;
+    size_t max_width;
+    size_t num_threads;
+    int reproducible;
+    size_t num_chunks;     // blocks (reproducible) or thread ranges
+    size_t chunk_rows;     // rows per chunk
+    size_t wave_chunks;    // chunks summed per wave; partials holds this many
+    double *partials;      // wave_chunks x max_width
+    double *stack;         // reproducible: completed subtrees, stack_depth x max_width
+    size_t *stack_level;   // height of each completed subtree
+    size_t stack_depth;
+    ThreadPool *pool;
+    size_t num_nodes;      // > 1 when chunks are grouped by NUMA node
+    size_t node_threads;   // threads per node, counting the node's first worker
+    size_t *node_chunks;   // NUMA: first chunk of each node, num_nodes + 1 entries
+    size_t *chunk_start;   // NUMA: first row of each chunk, num_chunks + 1 entries
+};
+
+typedef struct
+{
+    BlockReducer *reducer;
+    size_t width;
+    BlockKernel kernel;
+    void *ctx;
+    size_t wave_begin;     // chunks [wave_begin, wave_end) are being summed
+    size_t wave_end;
+    atomic_int failed;
+} ReduceRun;
+
+typedef struct
+{
+    ReduceRun *run;
+    size_t first_chunk;
+} NodeRun;
+
+/*
+ * Groups the chunks by the NUMA node that owns their rows (ml_numa_split,
+ * the same split ml_numa_place uses). Reproducible mode keeps the usual
+ * ML_REDUCE_BLOCK_ROWS blocks, which never straddle two nodes; otherwise
+ * each node's range is cut into one chunk per node thread.
+ */
+static int numa_layout(BlockReducer *r, size_t num_nodes)
+{
+    size_t num_rows = r->num_rows;
+
+    r->num_nodes = num_nodes;
+    r->node_threads = (r->num_threads + num_nodes - 1) / num_nodes;
+    r->node_chunks = malloc((num_nodes + 1) * sizeof(size_t));
+    if (!r->node_chunks) return -1;
+
+    size_t total = 0;
+
+    for (size_t n = 0; n < num_nodes; n++)
+    {
+        size_t begin, end;
+        ml_numa_split(num_rows, num_nodes, n, &begin, &end);
+
+        size_t rows = end - begin;
+        size_t chunks = r->reproducible ? (rows + ML_REDUCE_BLOCK_ROWS - 1) / ML_REDUCE_BLOCK_ROWS
+                                        : (rows < r->node_threads ? rows : r->node_threads);
+
+        r->node_chunks[n] = total;
+        total += chunks;
+    }
+
+    r->node_chunks[num_nodes] = total;
+    r->num_chunks = total;
+    r->chunk_start = malloc((total + 1) * sizeof(size_t));
+    if (!r->chunk_start) return -1;
+
+    for (size_t n = 0; n < num_nodes; n++)
+    {
+        size_t begin, end;
+        ml_numa_split(num_rows, num_nodes, n, &begin, &end);
+
+        size_t first = r->node_chunks[n];
+        size_t chunks = r->node_chunks[n + 1] - first;
+
+        for (size_t c = 0; c < chunks; c++)
+        {
+            r->chunk_start[first + c] = r->reproducible
+                ? begin + c * ML_REDUCE_BLOCK_ROWS
+                : begin + (end - begin) * c / chunks;
+        }
+    }
+
+    r->chunk_start[total] = num_rows;
+    return 0;
+}
+
+BlockReducer *block_reducer_create(size_t num_rows, size_t max_width,
+                                   size_t num_threads, int reproducible, int numa)
+{
+    BlockReducer *r = calloc(1, sizeof(BlockReducer));
+    if (!r) return NULL;
+
+    r->num_rows = num_rows;
+    r->max_width = max_width;
+    r->num_threads = num_threads ? num_threads : 1;
+    r->reproducible = reproducible;
+
+    if (reproducible)
+    {
+        r->chunk_rows = ML_REDUCE_BLOCK_ROWS;
+    }
+    else
+    {
+        r->chunk_rows = (num_rows + r->num_threads - 1) / r->num_threads;
+        if (r->chunk_rows == 0) r->chunk_rows = 1;
+    }
+
+    r->num_chunks = (num_rows + r->chunk_rows - 1) / r->chunk_rows;
+    r->num_nodes = 1;
+
+    size_t num_nodes = (numa && r->num_threads > 1) ? ml_numa_num_nodes() : 1;
+
+    if (num_nodes > 1 && numa_layout(r, num_nodes) != 0)
+    {
+        block_reducer_free(r);
+        return NULL;
+    }
+
+    // Thread ranges are few, but blocks grow with the rows: reproducible
+    // mode sums them in waves that fit the scratch budget (at least one
+    // block per thread) and keeps only the open subtrees of the tree
+    r->wave_chunks = r->num_chunks ? r->num_chunks : 1;
+
+    if (reproducible)
+    {
+        size_t budget = REDUCE_SCRATCH_BYTES / ((max_width ? max_width : 1) * sizeof(double));
+        if (budget < r->num_threads) budget = r->num_threads;
+        if (r->wave_chunks > budget) r->wave_chunks = budget;
+
+        r->stack_depth = 1;
+        for (size_t n = r->num_chunks; n > 1; n = (n + 1) / 2)
+            r->stack_depth++;
+
+        r->stack = malloc(r->stack_depth * (max_width ? max_width : 1) * sizeof(double));
+        r->stack_level = malloc(r->stack_depth * sizeof(size_t));
+
+        if (!r->stack || !r->stack_level)
+        {
+            block_reducer_free(r);
+            return NULL;
+        }
+    }
+
+    // A single serial chunk accumulates straight into the result
+    if (r->num_chunks > 1 || reproducible || r->num_nodes > 1)
+    {
+        r->partials = malloc(r->wave_chunks * max_width * sizeof(double));
+        if (!r->partials)
+        {
+            block_reducer_free(r);
+            return NULL;
+        }
+    }
+
+    if (r->num_threads > 1)
+        r->pool = thread_pool_shared();
+
+    return r;
+}
+
+// Sums one chunk of the current wave into partial slot `slot`
+static void reduce_chunk(void *arg, size_t slot)
+{
+    ReduceRun *run = arg;
+    BlockReducer *r = run->reducer;
+    double *partial = &r->partials[slot * r->max_width];
+    size_t c = run->wave_begin + slot;
+
+    size_t begin, end;
+
+    if (r->chunk_start)
+    {
+        begin = r->chunk_start[c];
+        end = r->chunk_start[c + 1];
+    }
+    else
+    {
+        begin = c * r->chunk_rows;
+        end = begin + r->chunk_rows;
+        if (end > r->num_rows) end = r->num_rows;
+    }
+
+    memset(partial, 0, run->width * sizeof(double));
+    run->kernel(run->ctx, begin, end, partial);
+}
+
+static void reduce_node_chunk(void *arg, size_t c)
+{
+    NodeRun *node_run = arg;
+    reduce_chunk(node_run->run, node_run->first_chunk - node_run->run->wave_begin + c);
+}
+
+// Runs on a worker pinned to node: its chunks of the wave, then (level 1)
+// their sum
+static void reduce_node(void *arg, size_t node)
+{
+    ReduceRun *run = arg;
+    BlockReducer *r = run->reducer;
+    size_t first = r->node_chunks[node];
+    size_t last = r->node_chunks[node + 1];
+
+    if (first < run->wave_begin) first = run->wave_begin;
+    if (last > run->wave_end) last = run->wave_end;
+    if (first >= last) return;
+
+    NodeRun node_run = { run, first };
+
+    if (thread_pool_parallel_for_limit(thread_pool_node(node), last - first, r->node_threads,
+                                       reduce_node_chunk, &node_run) != 0)
+    {
+        atomic_store(&run->failed, 1);
+        return;
+    }
+
+    // The reproducible tree needs every block, so only the plain sum is split
+    if (r->reproducible) return;
+
+    double *dst = &r->partials[first * r->max_width];
+
+    for (size_t c = first + 1; c < last; c++)
+    {
+        const double *src = &r->partials[c * r->max_width];
+
+        for (size_t k = 0; k < run->width; k++)
+            dst[k] += src[k];
+    }
+}
+
+/*
+ * Adds the block in slot to the fixed pairwise tree. Two completed
+ * subtrees of equal height are merged as soon as both exist, which adds
+ * exactly the pairs the level-by-level tree would, in the same order.
+ */
+static void tree_push(BlockReducer *r, size_t width, const double *block, size_t *depth)
+{
+    size_t level = 0;
+    double *top = &r->stack[*depth * r->max_width];
+
+    memcpy(top, block, width * sizeof(double));
+
+    while (*depth > 0 && r->stack_level[*depth - 1] == level)
+    {
+        double *left = &r->stack[(*depth - 1) * r->max_width];
+
+        for (size_t k = 0; k < width; k++)
+            left[k] += top[k];
+
+        top = left;
+        (*depth)--;
+        level++;
+    }
+
+    r->stack_level[*depth] = level;
+    (*depth)++;
+}
+
+// Sums the chunks of one wave into partials[0 .. wave_end - wave_begin)
+static int run_wave(BlockReducer *r, ReduceRun *run)
+{
+    if (r->num_nodes > 1)
+    {
+        return thread_pool_run_on_nodes(r->num_nodes, reduce_node, run) != 0 ||
+               atomic_load(&run->failed) ? -1 : 0;
+    }
+
+    return thread_pool_parallel_for_limit(r->pool, run->wave_end - run->wave_begin,
+                                          r->num_threads, reduce_chunk, run);
+}
+
+int block_reducer_run(BlockReducer *r, size_t width, BlockKernel kernel,
+                      void *ctx, double *result)
+{
+    if (!r || !kernel || !result || width > r->max_width) return -1;
+
+    memset(result, 0, width * sizeof(double));
+
+    if (!r->partials)
+    {
+        kernel(ctx, 0, r->num_rows, result);
+        return 0;
+    }
+
+    if (r->num_chunks == 0) return 0;
+
+    ReduceRun run = { r, width, kernel, ctx, 0, r->num_chunks, 0 };
+
+    if (r->reproducible)
+    {
+        // Fixed-shape pairwise tree over block index, built wave by wave
+        size_t depth = 0;
+
+        for (size_t begin = 0; begin < r->num_chunks; begin += r->wave_chunks)
+        {
+            run.wave_begin = begin;
+            run.wave_end = begin + r->wave_chunks < r->num_chunks ? begin + r->wave_chunks
+                                                                  : r->num_chunks;
+
+            if (run_wave(r, &run) != 0)
+                return -1;
+
+            for (size_t c = 0; c < run.wave_end - begin; c++)
+                tree_push(r, width, &r->partials[c * r->max_width], &depth);
+        }
+
+        // Close the ragged right edge: each open subtree takes the
+        // (smaller) rest of the tree as its right child
+        for (size_t i = depth - 1; i > 0; i--)
+        {
+            double *left = &r->stack[(i - 1) * r->max_width];
+            const double *right = &r->stack[i * r->max_width];
+
+            for (size_t k = 0; k < width; k++)
+                left[k] += right[k];
+        }
+
+        memcpy(result, r->stack, width * sizeof(double));
+        return 0;
+    }
+
+    if (run_wave(r, &run) != 0)
+        return -1;
+
+    // Level 2 of the NUMA sum: one partial per node, added in node order
+    if (r->num_nodes > 1)
+    {
+        for (size_t n = 0; n < r->num_nodes; n++)
+        {
+            if (r->node_chunks[n] == r->node_chunks[n + 1]) continue;
+
+            const double *src = &r->partials[r->node_chunks[n] * r->max_width];
+
+            for (size_t k = 0; k < width; k++)
+                result[k] += src[k];
+        }
+
+        return 0;
+    }
+
+    for (size_t c = 0; c < r->num_chunks; c++)
+    {
+        const double *src = &r->partials[c * r->max_width];
+
+        for (size_t k = 0; k < width; k++)
+            result[k] += src[k];
+    }
+
+    return 0;
+}
+
+void block_reducer_free(BlockReducer *reducer)
+{
+    if (!reducer) return;
+
+    free(reducer->partials);
+    free(reducer->stack);
+    free(reducer->stack_level);
+    free(reducer->node_chunks);
+    free(reducer->chunk_start);
+    free(reducer);
+}
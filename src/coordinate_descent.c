@@ -0,0 +1,410 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include "coordinate_descent.h"
+#include "utils.h"
+#include "ml_stats.h"
+
+/*
+ * State shared by both losses. Columns are read through row pointers
+ * gathered once, since X is row-major.
+ */
+typedef struct
+{
+    RegressionModel *model;
+    const DatasetView *data;
+    const double **rows;  // base pointer of every view row
+    double *col_sq;       // (1/n) sum_i x_ij^2
+    double *aux;          // residuals (linear) or logits (logistic)
+    double *prob;         // probabilities (logistic only)
+    double l1;
+    double l2;
+} CdState;
+
+typedef double (*CdUpdate)(CdState *st, size_t j);
+typedef double (*CdBiasUpdate)(CdState *st);
+
+static int cd_state_init(CdState *st, RegressionModel *model,
+                         const DatasetView *data, const RegressionConfig *config,
+                         int logistic)
+{
+    size_t n = data->num_rows;
+    size_t d = model->num_features;
+
+    memset(st, 0, sizeof(*st));
+    st->model = model;
+    st->data = data;
+    st->l1 = config->l1_penalty;
+    st->l2 = config->l2_penalty;
+
+    st->rows = malloc(n * sizeof(double *));
+    st->col_sq = calloc(d, sizeof(double));
+    st->aux = malloc(n * sizeof(double));
+    st->prob = logistic ? malloc(n * sizeof(double)) : NULL;
+
+    if (!st->rows || !st->col_sq || !st->aux || (logistic && !st->prob))
+        return -1;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        const double *row = view_row(data, i);
+        double z = model->bias;
+
+        st->rows[i] = row;
+
+        for (size_t j = 0; j < d; j++)
+        {
+            st->col_sq[j] += row[j] * row[j];
+            z += model->weights[j] * row[j];
+        }
+
+        if (logistic)
+        {
+            st->aux[i] = z;
+            st->prob[i] = sigmoid(z);
+        }
+        else
+        {
+            st->aux[i] = view_target(data, i) - z;
+        }
+    }
+
+    for (size_t j = 0; j < d; j++)
+        st->col_sq[j] /= n;
+
+    return 0;
+}
+
+static void cd_state_free(CdState *st)
+{
+    free(st->rows);
+    free(st->col_sq);
+    free(st->aux);
+    free(st->prob);
+}
+
+/*
+========================
+|  LINEAR (residuals)   |
+========================
+*/
+
+static double linear_update(CdState *st, size_t j)
+{
+    double h = st->col_sq[j];
+    if (h == 0.0) return 0.0;
+
+    size_t n = st->data->num_rows;
+    double g = 0.0;
+
+    for (size_t i = 0; i < n; i++)
+        g += st->rows[i][j] * st->aux[i];
+
+    double w_old = st->model->weights[j];
+    double w_new = soft_threshold(g / n + h * w_old, st->l1) / (h + st->l2);
+    double delta = w_new - w_old;
+
+    if (delta == 0.0) return 0.0;
+
+    st->model->weights[j] = w_new;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        double x = st->rows[i][j];
+        if (x != 0.0) st->aux[i] -= x * delta;
+    }
+
+    return fabs(delta);
+}
+
+static double linear_bias_update(CdState *st)
+{
+    size_t n = st->data->num_rows;
+    double mean = 0.0;
+
+    for (size_t i = 0; i < n; i++)
+        mean += st->aux[i];
+    mean /= n;
+
+    if (mean == 0.0) return 0.0;
+
+    st->model->bias += mean;
+
+    for (size_t i = 0; i < n; i++)
+        st->aux[i] -= mean;
+
+    return fabs(mean);
+}
+
+/*
+========================
+|  LOGISTIC (logits)    |
+========================
+*/
+
+static double logistic_update(CdState *st, size_t j)
+{
+    // Curvature of the mean log loss along x_j is at most col_sq / 4
+    double h = 0.25 * st->col_sq[j];
+    if (h == 0.0) return 0.0;
+
+    size_t n = st->data->num_rows;
+    double g = 0.0;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        double x = st->rows[i][j];
+        if (x != 0.0) g += x * (st->prob[i] - view_target(st->data, i));
+    }
+
+    double w_old = st->model->weights[j];
+    double w_new = soft_threshold(h * w_old - g / n, st->l1) / (h + st->l2);
+    double delta = w_new - w_old;
+
+    if (delta == 0.0) return 0.0;
+
+    st->model->weights[j] = w_new;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        double x = st->rows[i][j];
+        if (x != 0.0)
+        {
+            st->aux[i] += x * delta;
+            st->prob[i] = sigmoid(st->aux[i]);
+        }
+    }
+
+    return fabs(delta);
+}
+
+static double logistic_bias_update(CdState *st)
+{
+    size_t n = st->data->num_rows;
+    double g = 0.0;
+
+    for (size_t i = 0; i < n; i++)
+        g += st->prob[i] - view_target(st->data, i);
+
+    double delta = -(g / n) / 0.25;
+    if (delta == 0.0) return 0.0;
+
+    st->model->bias += delta;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        st->aux[i] += delta;
+        st->prob[i] = sigmoid(st->aux[i]);
+    }
+
+    return fabs(delta);
+}
+
+/*
+========================
+|  ACTIVE-SET DRIVER    |
+========================
+*/
+
+static int cd_solve(CdState *st, CdUpdate update, CdBiasUpdate bias_update,
+                    const RegressionConfig *config)
+{
+    RegressionModel *model = st->model;
+    size_t d = model->num_features;
+    double tol = config->early_stopping_threshold;
+
+    size_t *active = malloc((d ? d : 1) * sizeof(size_t));
+    if (!active) return -1;
+
+    size_t sweeps = 0;
+    model->stopping_iteration = config->num_iterations;
+
+    while (sweeps < config->num_iterations)
+    {
+        if (config->should_stop && config->should_stop(config->stop_ctx))
+        {
+            free(active);
+            return 1;
+        }
+
+        // Full sweep: lets zero coefficients enter the model
+        double max_delta = bias_update(st);
+        for (size_t j = 0; j < d; j++)
+            max_delta = fmax(max_delta, update(st, j));
+        sweeps++;
+        ML_STATS_COUNT(ML_STAT_ITERATIONS, 1);
+
+        if (max_delta <= tol)
+        {
+            model->stopping_iteration = sweeps;
+            break;
+        }
+
+        size_t num_active = 0;
+        for (size_t j = 0; j < d; j++)
+        {
+            if (model->weights[j] != 0.0)
+                active[num_active++] = j;
+        }
+
+        // Active-set sweeps skip the zero coefficients
+        while (sweeps < config->num_iterations)
+        {
+            max_delta = bias_update(st);
+            for (size_t a = 0; a < num_active; a++)
+                max_delta = fmax(max_delta, update(st, active[a]));
+            sweeps++;
+            ML_STATS_COUNT(ML_STAT_ITERATIONS, 1);
+
+            if (max_delta <= tol)
+                break;
+        }
+    }
+
+    free(active);
+    return 0;
+}
+
+static int cd_check_args(RegressionModel *model, const DatasetView *data,
+                         const RegressionConfig *config)
+{
+    if (!model || !model->weights || !data || !data->X || !data->y || !config)
+    {
+        fprintf(stderr, "Null pointer passed to coordinate descent.\n");
+        return -1;
+    }
+
+    if (data->num_rows == 0 || data->num_features != model->num_features)
+    {
+        fprintf(stderr, "Invalid data passed to coordinate descent.\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+static int cd_train(RegressionModel *model, const DatasetView *data,
+                    const RegressionConfig *config, int logistic)
+{
+    if (cd_check_args(model, data, config) != 0)
+        return -1;
+
+    model->trained = 0;
+
+    CdState st;
+    if (cd_state_init(&st, model, data, config, logistic) != 0)
+    {
+        fprintf(stderr, "Memory Allocation failed.\n");
+        cd_state_free(&st);
+        return -1;
+    }
+
+    ML_STATS_START(train_start);
+    ML_STATS_HW_BEGIN(hw);
+    ML_STATS_COUNT(ML_STAT_TRAIN_CALLS, 1);
+
+    int status = logistic
+        ? cd_solve(&st, logistic_update, logistic_bias_update, config)
+        : cd_solve(&st, linear_update, linear_bias_update, config);
+
+    ML_STATS_HW_END(hw);
+    ML_STATS_STOP(ML_STAT_TRAIN_NS, train_start);
+
+    cd_state_free(&st);
+
+    // A positive status means should_stop ended the solve
+    if (status < 0)
+        fprintf(stderr, "Memory Allocation failed.\n");
+
+    if (status != 0)
+        return -1;
+
+    model->trained = 1;
+    return 0;
+}
+
+int linreg_train_cd(RegressionModel *model, const DatasetView *data, const RegressionConfig *config)
+{
+    return cd_train(model, data, config, 0);
+}
+
+int logreg_train_cd(RegressionModel *model, const DatasetView *data, const RegressionConfig *config)
+{
+    return cd_train(model, data, config, 1);
+}
+
+static int fit_path(RegressionModel *model, const DatasetView *data,
+                    const RegressionConfig *config, const double *l1_path,
+                    size_t path_length, double *out, int logistic)
+{
+    if (!model || !config || !l1_path || !out)
+    {
+        fprintf(stderr, "Null pointer passed to fit_path.\n");
+        return -1;
+    }
+
+    size_t d = model->num_features;
+    RegressionConfig step = *config;
+
+    for (size_t k = 0; k < path_length; k++)
+    {
+        step.l1_penalty = l1_path[k];
+
+        // Weights are not reset, so each fit starts from the previous one
+        int status = logistic ? logreg_train_view(model, data, &step)
+                              : linreg_train_view(model, data, &step);
+        if (status != 0)
+            return -1;
+
+        memcpy(&out[k * (d + 1)], model->weights, d * sizeof(double));
+        out[k * (d + 1) + d] = model->bias;
+    }
+
+    return 0;
+}
+
+int linreg_fit_path(RegressionModel *model, const DatasetView *data, const RegressionConfig *config,
+                    const double *l1_path, size_t path_length, double *out)
+{
+    return fit_path(model, data, config, l1_path, path_length, out, 0);
+}
+
+int logreg_fit_path(RegressionModel *model, const DatasetView *data, const RegressionConfig *config,
+                    const double *l1_path, size_t path_length, double *out)
+{
+    return fit_path(model, data, config, l1_path, path_length, out, 1);
+}
+
+double lasso_lambda_max(const DatasetView *data)
+{
+    if (!data || !data->X || !data->y || data->num_rows == 0)
+        return 0.0;
+
+    size_t n = data->num_rows;
+    size_t d = data->num_features;
+    double y_mean = 0.0;
+
+    for (size_t i = 0; i < n; i++)
+        y_mean += view_target(data, i);
+    y_mean /= n;
+
+    double *corr = calloc(d ? d : 1, sizeof(double));
+    if (!corr) return 0.0;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        const double *row = view_row(data, i);
+        double r = view_target(data, i) - y_mean;
+
+        for (size_t j = 0; j < d; j++)
+            corr[j] += row[j] * r;
+    }
+
+    double lambda = 0.0;
+    for (size_t j = 0; j < d; j++)
+        lambda = fmax(lambda, fabs(corr[j]) / n);
+
+    free(corr);
+    return lambda;
+}
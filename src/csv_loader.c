@@ -1,10 +1,18 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <ctype.h>
 #include "csv_loader.h"
+#include "utils.h"
+#include "ml_stats.h"
+#include "ml_numa.h"
 
-#define MAX_BUF 512
+// Initial line buffer; read_whole_line doubles it for longer lines
+#define LINE_BUF 8192
+#define HASH_DEFAULT_BITS 18
+#define FNV_OFFSET 2166136261u
+#define FNV_PRIME 16777619u
 
 bool check_file_extension(const char *filename)
 {
@@ -34,91 +42,156 @@ bool is_number(const char *str)
     return has_digit;
 }
 
-bool has_header(FILE *f)
+// Reads one whole line into *buf, doubling *capacity until it fits.
+// Returns 1 for a line, 0 at end of file and -1 if the buffer cannot grow.
+static int read_whole_line(FILE *f, char **buf, size_t *capacity)
 {
-    char buf[MAX_BUF];
-    rewind(f);
+    size_t len = 0;
+
+    while (fgets(*buf + len, (int)(*capacity - len), f))
+    {
+        len += strlen(*buf + len);
 
-    if (!fgets(buf, sizeof(buf), f)) return false;
+        // A short read without '\n' is the file's last, unterminated line
+        if (len == 0 || (*buf)[len - 1] == '\n' || len + 1 < *capacity)
+            return 1;
 
-    char temp[MAX_BUF];
-    strncpy(temp, buf, sizeof(temp));
-    temp[sizeof(temp)-1] = '\0';
+        char *grown = realloc(*buf, *capacity * 2);
+        if (!grown) return -1;
 
-    char *tok = strtok(temp, ",");
-    return (tok == NULL || !is_number(tok));
+        *buf = grown;
+        *capacity *= 2;
+    }
+
+    return len > 0 ? 1 : 0;
 }
 
-int count_columns(FILE *f, bool header)
+bool has_header(FILE *f)
 {
-    char buf[MAX_BUF];
+    size_t capacity = LINE_BUF;
+    char *buf = malloc(capacity);
+    bool header = false;
+
     rewind(f);
 
-    if (!fgets(buf, sizeof(buf), f)) return 0;
+    if (buf && read_whole_line(f, &buf, &capacity) > 0)
+    {
+        char *tok = strtok(buf, ",");
+        header = tok == NULL || !is_number(tok);
+    }
 
-    if (header && !fgets(buf, sizeof(buf), f)) return 0;
+    free(buf);
+    return header;
+}
 
-    int cols = 0;
-    char *tok = strtok(buf, ",");
+size_t count_columns(FILE *f, bool header)
+{
+    size_t capacity = LINE_BUF;
+    char *buf = malloc(capacity);
+    size_t cols = 0;
 
-    while (tok)
+    rewind(f);
+
+    if (buf && read_whole_line(f, &buf, &capacity) > 0 &&
+        (!header || read_whole_line(f, &buf, &capacity) > 0))
     {
-        cols++;
-        tok = strtok(NULL, ",");
+        char *tok = strtok(buf, ",");
+
+        while (tok)
+        {
+            cols++;
+            tok = strtok(NULL, ",");
+        }
     }
 
+    free(buf);
     return cols;
 }
 
-int count_rows(FILE *f, bool header)
+size_t count_rows(FILE *f, bool header)
 {
-    char buf[MAX_BUF];
-    int rows = 0;
+    size_t capacity = LINE_BUF;
+    char *buf = malloc(capacity);
+    size_t rows = 0;
+    int line = buf ? 1 : -1;
 
     rewind(f);
 
-    if (header) fgets(buf, sizeof(buf), f);
+    if (header && line > 0)
+        line = read_whole_line(f, &buf, &capacity);
 
-    while (fgets(buf, sizeof(buf), f))
+    while (line > 0 && (line = read_whole_line(f, &buf, &capacity)) > 0)
         rows++;
 
-    return rows;
+    free(buf);
+    return line < 0 ? 0 : rows;
 }
 
-static void parse_csv(FILE *f, bool header,
-                      double *X, double *y,
-                      int rows, int features)
+static void parse_line(char *buf, double *x_row, double *y_row, size_t features, size_t targets)
 {
-    char buf[MAX_BUF];
-    rewind(f);
+    char *tok = strtok(buf, ",");
+    size_t j = 0;
+
+    while (tok)
+    {
+        double val = atof(tok);
+
+        if (j < features)
+            x_row[j] = val;
+        else if (j - features < targets)
+            y_row[j - features] = val;
 
-    if (header) fgets(buf, sizeof(buf), f);
+        j++;
+        tok = strtok(NULL, ",");
+    }
+}
+
+// Returns the number of rows parsed, fewer than rows on failure
+static size_t parse_csv(FILE *f, bool header,
+                        double *X, double *y,
+                        size_t rows, size_t features, size_t stride, size_t targets,
+                        FeatureScaler *scaler)
+{
+    size_t capacity = LINE_BUF;
+    char *buf = malloc(capacity);
+    if (!buf) return 0;
 
-    int i = 0;
+    rewind(f);
 
-    while (fgets(buf, sizeof(buf), f))
+    if (header && read_whole_line(f, &buf, &capacity) <= 0)
     {
-        char *tok = strtok(buf, ",");
-        int j = 0;
+        free(buf);
+        return 0;
+    }
 
-        while (tok)
-        {
-            double val = atof(tok);
+    size_t i = 0;
+    ML_STATS_TALLY(bytes);
 
-            if (j < features)
-                X[i * features + j] = val;
-            else
-                y[i] = val;
+    while (i < rows && read_whole_line(f, &buf, &capacity) > 0)
+    {
+        ML_STATS_TALLY_ADD(bytes, strlen(buf));
+        parse_line(buf, &X[i * stride], &y[i * targets], features, targets);
 
-            j++;
-            tok = strtok(NULL, ",");
-        }
+        // Row is still in cache, so the statistics cost no extra pass over X
+        if (scaler)
+            scaler_update(scaler, &X[i * stride]);
 
         i++;
     }
+
+    free(buf);
+
+    ML_STATS_COUNT(ML_STAT_BYTES_PARSED, bytes);
+    ML_STATS_COUNT(ML_STAT_ROWS_PARSED, i);
+    return i;
 }
 
 Dataset load_csv(const char *filename)
+{
+    return load_csv_ex(filename, NULL);
+}
+
+Dataset load_csv_ex(const char *filename, const CsvLoadOptions *options)
 {
     Dataset data = {0};
 
@@ -128,53 +201,524 @@ Dataset load_csv(const char *filename)
     FILE *f = fopen(filename, "r");
     if (!f) return data;
 
+    ML_STATS_START(load_start);
+
     bool header = has_header(f);
 
     data.cols = count_columns(f, header);
+    if (data.cols == 0)
+    {
+        fclose(f);
+        return data;
+    }
+
+    data.targets = (options && options->num_targets) ? options->num_targets : 1;
+    if (data.targets >= data.cols)
+    {
+        fclose(f);
+        data.targets = 0;
+        return data;
+    }
+
     data.rows = count_rows(f, header);
-    data.features = data.cols - 1;
+    data.features = data.cols - data.targets;
+    data.stride = data.features;
 
-    data.X = malloc(data.rows * data.features * sizeof(double));
-    data.y = malloc(data.rows * sizeof(double));
+    // Round each row up to a whole number of SIMD vectors
+    if (options && options->pad_rows)
+    {
+        size_t lane = ML_ALIGNMENT / sizeof(double);
+        data.stride = (data.features + lane - 1) / lane * lane;
+    }
+
+    size_t row_doubles = data.stride > data.targets ? data.stride : data.targets;
+    if (data.rows > SIZE_MAX / sizeof(double) / row_doubles)
+    {
+        fclose(f);
+        data.rows = 0;
+        return data;
+    }
+
+    int flags = (options && options->huge_pages) ? ML_ALLOC_HUGE_PAGES : 0;
+    size_t x_bytes = data.rows * data.stride * sizeof(double);
+
+    data.X = ml_aligned_alloc(x_bytes, flags);
+    data.y = ml_aligned_alloc(data.rows * data.targets * sizeof(double), flags);
 
     if (!data.X || !data.y)
     {
         fclose(f);
+        free_dataset(&data);
         data.rows = 0;
         return data;
     }
 
-    parse_csv(f, header, data.X, data.y, data.rows, data.features);
+    // Spread row blocks over the NUMA nodes before anything writes them.
+    // Only page-mapped arrays: a heap array shares its pages with other data.
+    if (options && options->numa)
+    {
+        if (ml_aligned_is_mapped(data.X))
+            ml_numa_place(data.X, data.stride * sizeof(double), data.rows);
+        if (ml_aligned_is_mapped(data.y))
+            ml_numa_place(data.y, data.targets * sizeof(double), data.rows);
+    }
+
+    // Padding lanes must read as zero for the vectorized kernels
+    if (data.stride != data.features)
+        memset(data.X, 0, x_bytes);
+
+    if (options && options->compute_scaler)
+    {
+        data.scaler = scaler_create(data.features);
+        if (!data.scaler)
+        {
+            fclose(f);
+            free_dataset(&data);
+            data.rows = 0;
+            return data;
+        }
+    }
+
+    size_t parsed = parse_csv(f, header, data.X, data.y, data.rows, data.features, data.stride,
+                              data.targets, data.scaler);
 
     fclose(f);
+
+    if (parsed != data.rows)
+    {
+        free_dataset(&data);
+        data.rows = 0;
+        return data;
+    }
+
+    ML_STATS_STOP(ML_STAT_LOAD_NS, load_start);
     return data;
 }
 
+static uint32_t fnv1a(uint32_t h, const char *s, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        h ^= (unsigned char)s[i];
+        h *= FNV_PRIME;
+    }
+
+    return h;
+}
+
+// Avalanche so the low bits used as the index depend on every input byte
+static uint32_t hash_finalize(uint32_t h)
+{
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
+
+// Strips blanks, line endings and surrounding double quotes in place
+static char *trim_field(char *tok, size_t *len)
+{
+    char *end = tok + strlen(tok);
+
+    while (tok < end && isspace((unsigned char)*tok)) tok++;
+    while (end > tok && isspace((unsigned char)end[-1])) end--;
+
+    if (end - tok >= 2 && *tok == '"' && end[-1] == '"')
+    {
+        tok++;
+        end--;
+    }
+
+    *end = '\0';
+    *len = (size_t)(end - tok);
+    return tok;
+}
+
+static bool parse_number(const char *tok, double *out)
+{
+    char *end;
+    *out = strtod(tok, &end);
+    return end != tok && *end == '\0';
+}
+
+typedef struct {
+    uint32_t idx;
+    double val;
+} HashedEntry;
+
+static void sort_entries(HashedEntry *e, size_t n)
+{
+    for (size_t i = 1; i < n; i++)
+    {
+        HashedEntry key = e[i];
+        size_t j = i;
+
+        while (j > 0 && e[j - 1].idx > key.idx)
+        {
+            e[j] = e[j - 1];
+            j--;
+        }
+
+        e[j] = key;
+    }
+}
+
+// Grows the CSR arrays to hold at least need non-zeros
+static bool reserve_nnz(SparseDataset *data, size_t *capacity, size_t need)
+{
+    if (need <= *capacity) return true;
+
+    size_t cap = *capacity ? *capacity : 1024;
+    while (cap < need) cap *= 2;
+
+    uint32_t *idx = realloc(data->col_idx, cap * sizeof(uint32_t));
+    if (idx) data->col_idx = idx;
+    double *val = realloc(data->values, cap * sizeof(double));
+    if (val) data->values = val;
+
+    if (!idx || !val) return false;
+
+    *capacity = cap;
+    return true;
+}
+
+static bool reserve_rows(SparseDataset *data, size_t *capacity, size_t need)
+{
+    if (need <= *capacity) return true;
+
+    size_t cap = *capacity ? *capacity * 2 : 1024;
+
+    size_t *ptr = realloc(data->row_ptr, (cap + 1) * sizeof(size_t));
+    if (ptr) data->row_ptr = ptr;
+    double *y = realloc(data->y, cap * sizeof(double));
+    if (y) data->y = y;
+
+    if (!ptr || !y) return false;
+
+    *capacity = cap;
+    return true;
+}
+
+SparseDataset load_csv_hashed(const char *filename, const CsvHashOptions *options)
+{
+    SparseDataset data = {0};
+
+    unsigned int bits = (options && options->hash_bits) ? options->hash_bits : HASH_DEFAULT_BITS;
+    bool signed_hash = options && options->signed_hash;
+
+    if (!check_file_extension(filename) || bits > 31)
+        return data;
+
+    FILE *f = fopen(filename, "r");
+    if (!f) return data;
+
+    ML_STATS_START(load_start);
+
+    size_t buf_capacity = LINE_BUF;
+    char *buf = malloc(buf_capacity);
+    bool header = false;
+    int line = 0;
+    uint32_t *seeds = NULL;
+    HashedEntry *entries = NULL;
+    size_t num_seeds = 0;
+    size_t row_capacity = 0;
+    size_t nnz_capacity = 0;
+    ML_STATS_TALLY(bytes);
+    bool ok = buf != NULL;
+    uint32_t mask = (uint32_t)(((uint64_t)1 << bits) - 1);
+
+    data.num_features = (size_t)1 << bits;
+
+    while (ok && (line = read_whole_line(f, &buf, &buf_capacity)) > 0)
+    {
+        ML_STATS_TALLY_ADD(bytes, strlen(buf));
+
+        // Split on commas by hand: strtok would merge empty fields
+        size_t fields = 1;
+        for (char *c = buf; *c; c++)
+            if (*c == ',') fields++;
+
+        bool first_line = seeds == NULL;
+
+        if (first_line)
+        {
+            num_seeds = fields;
+            seeds = malloc(num_seeds * sizeof(uint32_t));
+            entries = malloc(num_seeds * sizeof(HashedEntry));
+            if (!seeds || !entries) { ok = false; break; }
+
+            // The last column is the numeric target, so a name there marks a
+            // header whatever the categorical columns before it hold
+            char *last = strrchr(buf, ',');
+            size_t target_len;
+            char *target = trim_field(last ? last + 1 : buf, &target_len);
+            double value;
+
+            header = target_len > 0 && !parse_number(target, &value);
+        }
+
+        // Column keys come from the header names, or from the positions
+        if (first_line && header)
+        {
+            char *tok = buf;
+            for (size_t c = 0; c < num_seeds; c++)
+            {
+                char *comma = strchr(tok, ',');
+                if (comma) *comma = '\0';
+
+                size_t len;
+                char *name = trim_field(tok, &len);
+                seeds[c] = fnv1a(FNV_OFFSET, name, len);
+                tok = comma ? comma + 1 : tok + strlen(tok);
+            }
+            continue;
+        }
+
+        if (first_line)
+        {
+            for (size_t c = 0; c < num_seeds; c++)
+            {
+                char key[32];
+                int len = snprintf(key, sizeof(key), "%zu", c);
+                seeds[c] = fnv1a(FNV_OFFSET, key, (size_t)len);
+            }
+        }
+
+        if (fields < 2) continue;  // blank line
+
+        if (!reserve_rows(&data, &row_capacity, data.rows + 1) ||
+            !reserve_nnz(&data, &nnz_capacity, data.nnz + fields))
+        {
+            ok = false;
+            break;
+        }
+
+        size_t count = 0;
+        bool has_target = false;
+        char *tok = buf;
+
+        for (size_t c = 0; c < fields; c++)
+        {
+            char *comma = strchr(tok, ',');
+            if (comma) *comma = '\0';
+
+            size_t len;
+            char *field = trim_field(tok, &len);
+            tok = comma ? comma + 1 : tok + strlen(tok);
+
+            if (c == fields - 1)
+            {
+                has_target = parse_number(field, &data.y[data.rows]);
+                break;
+            }
+
+            if (len == 0 || c >= num_seeds) continue;
+
+            double value;
+            uint32_t h;
+
+            if (parse_number(field, &value))
+            {
+                if (value == 0.0) continue;
+                h = seeds[c];
+            }
+            else
+            {
+                value = 1.0;
+                h = fnv1a(fnv1a(seeds[c], "=", 1), field, len);
+            }
+
+            h = hash_finalize(h);
+
+            if (signed_hash && (hash_finalize(h ^ 0x9e3779b9u) & 1))
+                value = -value;
+
+            entries[count].idx = h & mask;
+            entries[count].val = value;
+            count++;
+        }
+
+        // A missing or non-numeric target would otherwise train as 0
+        if (!has_target)
+        {
+            data.skipped_rows++;
+            continue;
+        }
+
+        // Colliding features in one row are summed
+        sort_entries(entries, count);
+
+        data.row_ptr[data.rows] = data.nnz;
+
+        for (size_t k = 0; k < count; k++)
+        {
+            if (data.nnz > data.row_ptr[data.rows] && data.col_idx[data.nnz - 1] == entries[k].idx)
+            {
+                data.values[data.nnz - 1] += entries[k].val;
+                continue;
+            }
+
+            data.col_idx[data.nnz] = entries[k].idx;
+            data.values[data.nnz] = entries[k].val;
+            data.nnz++;
+        }
+
+        data.rows++;
+        data.row_ptr[data.rows] = data.nnz;
+    }
+
+    fclose(f);
+    free(buf);
+    free(seeds);
+    free(entries);
+
+    if (!ok || line < 0 || data.rows == 0)
+    {
+        free_sparse_dataset(&data);
+        memset(&data, 0, sizeof(data));
+        return data;
+    }
+
+    ML_STATS_STOP(ML_STAT_LOAD_NS, load_start);
+    ML_STATS_COUNT(ML_STAT_BYTES_PARSED, bytes);
+    ML_STATS_COUNT(ML_STAT_ROWS_PARSED, data.rows);
+
+    return data;
+}
+
+bool csv_reader_open(CsvReader *reader, const char *filename)
+{
+    if (!reader) return false;
+
+    reader->f = NULL;
+    reader->cols = 0;
+    reader->features = 0;
+    reader->line = NULL;
+    reader->line_capacity = 0;
+
+    if (!check_file_extension(filename))
+        return false;
+
+    FILE *f = fopen(filename, "r");
+    if (!f) return false;
+
+    bool header = has_header(f);
+
+    reader->cols = count_columns(f, header);
+
+    if (reader->cols == 0)
+    {
+        fclose(f);
+        return false;
+    }
+
+    reader->features = reader->cols - 1;
+    reader->line_capacity = LINE_BUF;
+    reader->line = malloc(reader->line_capacity);
+
+    // Position the stream at the first data row
+    rewind(f);
+
+    if (!reader->line || (header && read_whole_line(f, &reader->line, &reader->line_capacity) < 0))
+    {
+        free(reader->line);
+        reader->line = NULL;
+        fclose(f);
+        return false;
+    }
+
+    reader->f = f;
+    return true;
+}
+
+size_t csv_read_block(CsvReader *reader, double *X, double *y, size_t max_rows)
+{
+    if (!reader || !reader->f || !X || !y) return 0;
+
+    size_t i = 0;
+    int line = 0;
+    ML_STATS_TALLY(bytes);
+
+    ML_STATS_START(load_start);
+
+    while (i < max_rows &&
+           (line = read_whole_line(reader->f, &reader->line, &reader->line_capacity)) > 0)
+    {
+        ML_STATS_TALLY_ADD(bytes, strlen(reader->line));
+        parse_line(reader->line, &X[i * reader->features], &y[i], reader->features, 1);
+        i++;
+    }
+
+    // A line that could not be read whole ends the stream rather than
+    // resuming mid-line on the next call
+    if (line < 0)
+        fseek(reader->f, 0, SEEK_END);
+
+    ML_STATS_STOP(ML_STAT_LOAD_NS, load_start);
+    ML_STATS_COUNT(ML_STAT_BYTES_PARSED, bytes);
+    ML_STATS_COUNT(ML_STAT_ROWS_PARSED, i);
+
+    return i;
+}
+
+void csv_reader_close(CsvReader *reader)
+{
+    if (!reader || !reader->f) return;
+
+    fclose(reader->f);
+    reader->f = NULL;
+    free(reader->line);
+    reader->line = NULL;
+}
+
+DatasetView dataset_view(const Dataset *data)
+{
+    const double *y = data->targets > 1 ? NULL : data->y;
+    DatasetView v = view_create(data->X, y, data->rows, data->features);
+    v.row_stride = data->stride ? data->stride : data->features;
+    return v;
+}
+
 void free_dataset(Dataset *data)
 {
     if (!data) return;
 
-    free(data->X);
-    free(data->y);
+    ml_aligned_free(data->X);
+    ml_aligned_free(data->y);
+    scaler_free(data->scaler);
 
     data->X = NULL;
     data->y = NULL;
+    data->scaler = NULL;
 }
 
 void print_dataset(const Dataset *data)
 {
-    for (int i = 0; i < data->rows; i++)
+    size_t stride = data->stride ? data->stride : data->features;
+
+    for (size_t i = 0; i < data->rows; i++)
     {
-        printf("Row %d -> X: [", i);
+        printf("Row %zu -> X: [", i);
 
-        for (int j = 0; j < data->features; j++)
+        for (size_t j = 0; j < data->features; j++)
         {
-            printf("%.2f", data->X[i * data->features + j]);
+            printf("%.2f", data->X[i * stride + j]);
             if (j != data->features - 1)
                 printf(", ");
         }
 
-        printf("], y: %.2f\n", data->y[i]);
+        size_t targets = data->targets ? data->targets : 1;
+
+        printf("], y: ");
+        for (size_t t = 0; t < targets; t++)
+        {
+            printf("%.2f", data->y[i * targets + t]);
+            if (t != targets - 1)
+                printf(", ");
+        }
+        printf("\n");
     }
 }
 
@@ -196,7 +740,7 @@ int main()
         return 1;
     }
 
-    printf("Rows: %d, Cols: %d\n", data.rows, data.cols);
+    printf("Rows: %zu, Cols: %zu\n", data.rows, data.cols);
 
     print_dataset(&data);
 
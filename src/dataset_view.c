@@ -0,0 +1,137 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "dataset_view.h"
+#include "utils.h"
+
+DatasetView view_create(const double *X, const double *y, size_t num_rows, size_t num_features)
+{
+    DatasetView v = {0};
+
+    v.X = X;
+    v.y = y;
+    v.rows = NULL;
+    v.num_rows = num_rows;
+    v.num_features = num_features;
+    v.row_stride = num_features;
+    v.owns_rows = 0;
+
+    return v;
+}
+
+// Copies the base-row indices of base into a fresh array
+static size_t *view_copy_rows(const DatasetView *base)
+{
+    size_t *rows = malloc((base->num_rows ? base->num_rows : 1) * sizeof(size_t));
+    if (!rows) return NULL;
+
+    for (size_t i = 0; i < base->num_rows; i++)
+        rows[i] = view_base_row(base, i);
+
+    return rows;
+}
+
+static void view_permute(size_t *rows, size_t n, unsigned int seed)
+{
+    uint64_t state = random_init(seed);
+
+    // Fisher-Yates
+    for (size_t i = n; i > 1; i--)
+    {
+        size_t j = (size_t)(random_next(&state) % i);
+        size_t tmp = rows[i - 1];
+        rows[i - 1] = rows[j];
+        rows[j] = tmp;
+    }
+}
+
+static DatasetView view_derive(const DatasetView *base, size_t *rows, size_t num_rows)
+{
+    DatasetView v = *base;
+
+    v.rows = rows;
+    v.num_rows = num_rows;
+    v.owns_rows = 1;
+
+    return v;
+}
+
+int view_shuffle(const DatasetView *base, unsigned int seed, DatasetView *out)
+{
+    if (!base || !out) return -1;
+
+    size_t *rows = view_copy_rows(base);
+    if (!rows)
+    {
+        fprintf(stderr, "Memory Allocation failed.\n");
+        return -1;
+    }
+
+    view_permute(rows, base->num_rows, seed);
+
+    *out = view_derive(base, rows, base->num_rows);
+    return 0;
+}
+
+int view_train_test_split(const DatasetView *base, double test_fraction, unsigned int seed,
+                          DatasetView *train, DatasetView *test)
+{
+    if (!base || !train || !test || test_fraction < 0.0 || test_fraction > 1.0)
+        return -1;
+
+    size_t n = base->num_rows;
+    size_t n_test = (size_t)(test_fraction * (double)n);
+    size_t n_train = n - n_test;
+
+    size_t *train_rows = view_copy_rows(base);
+    size_t *test_rows = malloc((n_test ? n_test : 1) * sizeof(size_t));
+
+    if (!train_rows || !test_rows)
+    {
+        fprintf(stderr, "Memory Allocation failed.\n");
+        free(train_rows);
+        free(test_rows);
+        return -1;
+    }
+
+    view_permute(train_rows, n, seed);
+
+    // Tail of the permutation becomes the test set
+    for (size_t i = 0; i < n_test; i++)
+        test_rows[i] = train_rows[n_train + i];
+
+    *train = view_derive(base, train_rows, n_train);
+    *test = view_derive(base, test_rows, n_test);
+    return 0;
+}
+
+int view_bootstrap(const DatasetView *base, size_t num_rows, unsigned int seed, DatasetView *out)
+{
+    if (!base || !out || base->num_rows == 0) return -1;
+
+    size_t *rows = malloc((num_rows ? num_rows : 1) * sizeof(size_t));
+    if (!rows)
+    {
+        fprintf(stderr, "Memory Allocation failed.\n");
+        return -1;
+    }
+
+    uint64_t state = random_init(seed);
+
+    for (size_t i = 0; i < num_rows; i++)
+        rows[i] = view_base_row(base, (size_t)(random_next(&state) % base->num_rows));
+
+    *out = view_derive(base, rows, num_rows);
+    return 0;
+}
+
+void view_release(DatasetView *view)
+{
+    if (!view) return;
+
+    if (view->owns_rows)
+        free((size_t *)view->rows);
+
+    view->rows = NULL;
+    view->num_rows = 0;
+    view->owns_rows = 0;
+}
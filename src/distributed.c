@@ -0,0 +1,569 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "distributed.h"
+
+// Doubles exchanged per round; larger buffers are reduced in chunks
+#define TRANSPORT_CHUNK 4096
+
+// How long non-root ranks wait for rank 0 to come up (milliseconds)
+#define TRANSPORT_CONNECT_TIMEOUT_MS 30000
+
+void ml_transport_destroy(MLTransport *t)
+{
+    if (!t) return;
+
+    if (t->destroy)
+        t->destroy(t);
+    else
+        free(t);
+}
+
+static int transport_reduce(void *ctx, double *buf, size_t count)
+{
+    MLTransport *t = ctx;
+    return t->allreduce(t, buf, count);
+}
+
+int ml_train_distributed(MLModel *model,
+                         const DatasetView *shard,
+                         const RegressionConfig *config,
+                         MLTransport *transport)
+{
+    if (!transport || !transport->allreduce)
+    {
+        fprintf(stderr, "Invalid transport passed to ml_train_distributed.\n");
+        return -1;
+    }
+
+    GradientReducer reducer = { transport_reduce, transport };
+    return ml_train_reduced(model, shard, config, &reducer);
+}
+
+#ifdef _WIN32
+
+MLTransport *ml_transport_shm_create(const char *name, int rank, int world_size)
+{
+    (void)name; (void)rank; (void)world_size;
+    fprintf(stderr, "Shared-memory transport is not supported on this platform.\n");
+    return NULL;
+}
+
+MLTransport *ml_transport_socket_create(const char *address, int rank, int world_size)
+{
+    (void)address; (void)rank; (void)world_size;
+    fprintf(stderr, "Socket transport is not supported on this platform.\n");
+    return NULL;
+}
+
+#else
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+static void sleep_ms(long ms)
+{
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+/*
+========================
+|  SHARED MEMORY        |
+========================
+*/
+
+typedef struct
+{
+    atomic_int ready;       // set by rank 0 once the segment is initialized
+    atomic_int arrived;     // barrier arrivals in the current generation
+    atomic_int generation;  // barrier generation counter
+    int world_size;
+    double slots[];         // world_size * TRANSPORT_CHUNK contributions
+} ShmSegment;
+
+typedef struct
+{
+    ShmSegment *seg;
+    size_t size;
+    char name[256];
+} ShmTransport;
+
+static size_t shm_segment_size(int world_size)
+{
+    return sizeof(ShmSegment) + (size_t)world_size * TRANSPORT_CHUNK * sizeof(double);
+}
+
+static void shm_barrier(ShmSegment *seg)
+{
+    int gen = atomic_load(&seg->generation);
+
+    if (atomic_fetch_add(&seg->arrived, 1) == seg->world_size - 1)
+    {
+        atomic_store(&seg->arrived, 0);
+        atomic_fetch_add(&seg->generation, 1);
+    }
+    else
+    {
+        while (atomic_load(&seg->generation) == gen)
+            sched_yield();
+    }
+}
+
+static int shm_allreduce(MLTransport *t, double *buf, size_t count)
+{
+    ShmTransport *st = t->impl;
+    ShmSegment *seg = st->seg;
+
+    for (size_t off = 0; off < count; off += TRANSPORT_CHUNK)
+    {
+        size_t n = count - off < TRANSPORT_CHUNK ? count - off : TRANSPORT_CHUNK;
+
+        memcpy(&seg->slots[(size_t)t->rank * TRANSPORT_CHUNK], buf + off, n * sizeof(double));
+        shm_barrier(seg);
+
+        // Every rank sums in rank order, so all see the same bits
+        for (size_t k = 0; k < n; k++)
+        {
+            double acc = seg->slots[k];
+
+            for (int r = 1; r < t->world_size; r++)
+                acc += seg->slots[(size_t)r * TRANSPORT_CHUNK + k];
+
+            buf[off + k] = acc;
+        }
+
+        // Nobody may overwrite its slot until everyone has read
+        shm_barrier(seg);
+    }
+
+    return 0;
+}
+
+static void shm_destroy(MLTransport *t)
+{
+    ShmTransport *st = t->impl;
+
+    if (st)
+    {
+        if (st->seg)
+            munmap(st->seg, st->size);
+
+        if (t->rank == 0)
+            shm_unlink(st->name);
+
+        free(st);
+    }
+
+    free(t);
+}
+
+MLTransport *ml_transport_shm_create(const char *name, int rank, int world_size)
+{
+    if (!name || name[0] != '/' || strlen(name) >= 256 ||
+        world_size < 1 || rank < 0 || rank >= world_size)
+    {
+        fprintf(stderr, "Invalid arguments passed to ml_transport_shm_create.\n");
+        return NULL;
+    }
+
+    MLTransport *t = calloc(1, sizeof(MLTransport));
+    ShmTransport *st = calloc(1, sizeof(ShmTransport));
+
+    if (!t || !st)
+    {
+        fprintf(stderr, "Memory Allocation failed.\n");
+        free(t);
+        free(st);
+        return NULL;
+    }
+
+    t->rank = rank;
+    t->world_size = world_size;
+    t->allreduce = shm_allreduce;
+    t->destroy = shm_destroy;
+    t->impl = st;
+
+    strcpy(st->name, name);
+    st->size = shm_segment_size(world_size);
+
+    int fd = -1;
+
+    if (rank == 0)
+    {
+        shm_unlink(name);   // stale segment from a crashed job
+        fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+
+        if (fd < 0 || ftruncate(fd, (off_t)st->size) != 0)
+        {
+            fprintf(stderr, "Failed to create shared memory %s: %s\n", name, strerror(errno));
+            if (fd >= 0) close(fd);
+            shm_destroy(t);
+            return NULL;
+        }
+    }
+    else
+    {
+        // Wait until rank 0 has created and sized the segment
+        for (long waited = 0; ; waited += 10)
+        {
+            fd = shm_open(name, O_RDWR, 0600);
+
+            if (fd >= 0)
+            {
+                struct stat sb;
+                if (fstat(fd, &sb) == 0 && (size_t)sb.st_size >= st->size)
+                    break;
+
+                close(fd);
+                fd = -1;
+            }
+
+            if (waited >= TRANSPORT_CONNECT_TIMEOUT_MS)
+            {
+                fprintf(stderr, "Timed out waiting for shared memory %s.\n", name);
+                free(st);
+                free(t);
+                return NULL;
+            }
+
+            sleep_ms(10);
+        }
+    }
+
+    void *mem = mmap(NULL, st->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (mem == MAP_FAILED)
+    {
+        fprintf(stderr, "Failed to map shared memory %s: %s\n", name, strerror(errno));
+        shm_destroy(t);
+        return NULL;
+    }
+
+    st->seg = mem;
+
+    if (rank == 0)
+    {
+        atomic_init(&st->seg->arrived, 0);
+        atomic_init(&st->seg->generation, 0);
+        st->seg->world_size = world_size;
+        atomic_store(&st->seg->ready, 1);
+    }
+    else
+    {
+        while (!atomic_load(&st->seg->ready))
+            sched_yield();
+    }
+
+    // Rank 0 must not unlink before every rank has mapped the segment
+    shm_barrier(st->seg);
+    return t;
+}
+
+/*
+========================
+|  SOCKETS              |
+========================
+*/
+
+typedef struct
+{
+    int *fds;           // rank 0: one connection per peer rank; others: fds[0] is rank 0
+    double *scratch;    // rank 0: receive buffer for one chunk
+    char unix_path[108];
+} SocketTransport;
+
+static int send_all(int fd, const void *data, size_t len)
+{
+    const char *p = data;
+
+    while (len > 0)
+    {
+        ssize_t n = send(fd, p, len, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+
+        p += n;
+        len -= (size_t)n;
+    }
+
+    return 0;
+}
+
+static int recv_all(int fd, void *data, size_t len)
+{
+    char *p = data;
+
+    while (len > 0)
+    {
+        ssize_t n = recv(fd, p, len, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+
+        p += n;
+        len -= (size_t)n;
+    }
+
+    return 0;
+}
+
+static int socket_allreduce(MLTransport *t, double *buf, size_t count)
+{
+    SocketTransport *st = t->impl;
+
+    for (size_t off = 0; off < count; off += TRANSPORT_CHUNK)
+    {
+        size_t n = count - off < TRANSPORT_CHUNK ? count - off : TRANSPORT_CHUNK;
+        size_t bytes = n * sizeof(double);
+
+        if (t->rank != 0)
+        {
+            if (send_all(st->fds[0], buf + off, bytes) != 0 ||
+                recv_all(st->fds[0], buf + off, bytes) != 0)
+                return -1;
+
+            continue;
+        }
+
+        // Rank 0 gathers in rank order, matching the shared-memory sum
+        for (int r = 1; r < t->world_size; r++)
+        {
+            if (recv_all(st->fds[r], st->scratch, bytes) != 0)
+                return -1;
+
+            for (size_t k = 0; k < n; k++)
+                buf[off + k] += st->scratch[k];
+        }
+
+        for (int r = 1; r < t->world_size; r++)
+        {
+            if (send_all(st->fds[r], buf + off, bytes) != 0)
+                return -1;
+        }
+    }
+
+    return 0;
+}
+
+static void socket_destroy(MLTransport *t)
+{
+    SocketTransport *st = t->impl;
+
+    if (st)
+    {
+        if (st->fds)
+        {
+            for (int r = 0; r < t->world_size; r++)
+            {
+                if (st->fds[r] >= 0) close(st->fds[r]);
+            }
+        }
+
+        if (t->rank == 0 && st->unix_path[0])
+            unlink(st->unix_path);
+
+        free(st->fds);
+        free(st->scratch);
+        free(st);
+    }
+
+    free(t);
+}
+
+// Resolves "unix:/path" or "tcp:host:port" into a socket address
+static int parse_address(const char *address, struct sockaddr_storage *addr,
+                         socklen_t *addr_len, int *family)
+{
+    memset(addr, 0, sizeof(*addr));
+
+    if (strncmp(address, "unix:", 5) == 0)
+    {
+        struct sockaddr_un *un = (struct sockaddr_un *)addr;
+        const char *path = address + 5;
+
+        if (strlen(path) >= sizeof(un->sun_path)) return -1;
+
+        un->sun_family = AF_UNIX;
+        strcpy(un->sun_path, path);
+        *addr_len = sizeof(struct sockaddr_un);
+        *family = AF_UNIX;
+        return 0;
+    }
+
+    if (strncmp(address, "tcp:", 4) == 0)
+    {
+        char host[256];
+        const char *colon = strrchr(address + 4, ':');
+
+        if (!colon || (size_t)(colon - (address + 4)) >= sizeof(host)) return -1;
+
+        memcpy(host, address + 4, (size_t)(colon - (address + 4)));
+        host[colon - (address + 4)] = '\0';
+
+        struct addrinfo hints = {0};
+        struct addrinfo *res = NULL;
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        if (getaddrinfo(host, colon + 1, &hints, &res) != 0 || !res) return -1;
+
+        memcpy(addr, res->ai_addr, res->ai_addrlen);
+        *addr_len = res->ai_addrlen;
+        *family = res->ai_family;
+        freeaddrinfo(res);
+        return 0;
+    }
+
+    return -1;
+}
+
+static void set_nodelay(int fd, int family)
+{
+    if (family == AF_UNIX) return;
+
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+MLTransport *ml_transport_socket_create(const char *address, int rank, int world_size)
+{
+    struct sockaddr_storage addr;
+    socklen_t addr_len;
+    int family;
+
+    if (!address || world_size < 1 || rank < 0 || rank >= world_size ||
+        parse_address(address, &addr, &addr_len, &family) != 0)
+    {
+        fprintf(stderr, "Invalid arguments passed to ml_transport_socket_create.\n");
+        return NULL;
+    }
+
+    MLTransport *t = calloc(1, sizeof(MLTransport));
+    SocketTransport *st = calloc(1, sizeof(SocketTransport));
+    int *fds = malloc((size_t)world_size * sizeof(int));
+
+    if (!t || !st || !fds)
+    {
+        fprintf(stderr, "Memory Allocation failed.\n");
+        free(t);
+        free(st);
+        free(fds);
+        return NULL;
+    }
+
+    for (int r = 0; r < world_size; r++)
+        fds[r] = -1;
+
+    t->rank = rank;
+    t->world_size = world_size;
+    t->allreduce = socket_allreduce;
+    t->destroy = socket_destroy;
+    t->impl = st;
+    st->fds = fds;
+
+    if (rank == 0)
+    {
+        st->scratch = malloc(TRANSPORT_CHUNK * sizeof(double));
+
+        int lfd = socket(family, SOCK_STREAM, 0);
+        if (!st->scratch || lfd < 0)
+        {
+            fprintf(stderr, "Failed to create listening socket.\n");
+            if (lfd >= 0) close(lfd);
+            socket_destroy(t);
+            return NULL;
+        }
+
+        if (family == AF_UNIX)
+        {
+            strcpy(st->unix_path, ((struct sockaddr_un *)&addr)->sun_path);
+            unlink(st->unix_path);
+        }
+        else
+        {
+            int one = 1;
+            setsockopt(lfd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        }
+
+        if (bind(lfd, (struct sockaddr *)&addr, addr_len) != 0 ||
+            listen(lfd, world_size) != 0)
+        {
+            fprintf(stderr, "Failed to listen on %s: %s\n", address, strerror(errno));
+            close(lfd);
+            socket_destroy(t);
+            return NULL;
+        }
+
+        // Peers identify themselves by sending their rank
+        for (int accepted = 1; accepted < world_size; accepted++)
+        {
+            int fd = accept(lfd, NULL, NULL);
+            int peer = -1;
+
+            if (fd < 0 || recv_all(fd, &peer, sizeof(peer)) != 0 ||
+                peer <= 0 || peer >= world_size || fds[peer] >= 0)
+            {
+                fprintf(stderr, "Failed to accept peer on %s.\n", address);
+                if (fd >= 0) close(fd);
+                close(lfd);
+                socket_destroy(t);
+                return NULL;
+            }
+
+            set_nodelay(fd, family);
+            fds[peer] = fd;
+        }
+
+        close(lfd);
+        return t;
+    }
+
+    // Non-root: retry until rank 0 is listening
+    for (long waited = 0; ; waited += 10)
+    {
+        int fd = socket(family, SOCK_STREAM, 0);
+
+        if (fd >= 0 && connect(fd, (struct sockaddr *)&addr, addr_len) == 0)
+        {
+            set_nodelay(fd, family);
+            fds[0] = fd;
+            break;
+        }
+
+        if (fd >= 0) close(fd);
+
+        if (waited >= TRANSPORT_CONNECT_TIMEOUT_MS)
+        {
+            fprintf(stderr, "Timed out connecting to %s.\n", address);
+            socket_destroy(t);
+            return NULL;
+        }
+
+        sleep_ms(10);
+    }
+
+    if (send_all(fds[0], &rank, sizeof(rank)) != 0)
+    {
+        fprintf(stderr, "Failed to register with %s.\n", address);
+        socket_destroy(t);
+        return NULL;
+    }
+
+    return t;
+}
+
+#endif
@@ -0,0 +1,242 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "ensemble.h"
+
+/*
+ * Internal structure definition
+ */
+struct MLEnsemble {
+    MLModelType type;
+    size_t num_features;
+    size_t num_members;
+    RegressionModel **members;
+    double *weights;   // num_members x num_features, packed after training
+    double *biases;    // num_members
+    int trained;
+};
+
+/*
+ * Per-call state shared by the member training tasks
+ */
+typedef struct {
+    MLEnsemble *ensemble;
+    const DatasetView *data;
+    const RegressionConfig *config;
+    unsigned int seed;
+    atomic_int failed;
+} EnsembleJob;
+
+MLEnsemble *ml_ensemble_create(MLModelType type,
+                               size_t num_features,
+                               size_t num_members)
+{
+    if (num_members == 0 || (type != ML_LINEAR && type != ML_LOGISTIC))
+        return NULL;
+
+    MLEnsemble *e = calloc(1, sizeof(MLEnsemble));
+    if (!e) return NULL;
+
+    e->type = type;
+    e->num_features = num_features;
+    e->num_members = num_members;
+    e->members = calloc(num_members, sizeof(RegressionModel *));
+    e->weights = calloc(num_members * num_features, sizeof(double));
+    e->biases = calloc(num_members, sizeof(double));
+
+    if (!e->members || !e->weights || !e->biases)
+    {
+        ml_ensemble_destroy(e);
+        return NULL;
+    }
+
+    for (size_t m = 0; m < num_members; m++)
+    {
+        e->members[m] = (type == ML_LINEAR) ? linreg_create(num_features)
+                                            : logreg_create(num_features);
+        if (!e->members[m])
+        {
+            ml_ensemble_destroy(e);
+            return NULL;
+        }
+    }
+
+    return e;
+}
+
+static void ensemble_train_member(void *ctx, size_t m)
+{
+    EnsembleJob *job = ctx;
+    MLEnsemble *e = job->ensemble;
+    DatasetView sample;
+
+    // Distinct, reproducible stream per member
+    unsigned int member_seed = job->seed * 2654435761u + (unsigned int)m;
+
+    if (view_bootstrap(job->data, job->data->num_rows, member_seed, &sample) != 0)
+    {
+        atomic_store(&job->failed, 1);
+        return;
+    }
+
+    int status = (e->type == ML_LINEAR)
+        ? linreg_train_view(e->members[m], &sample, job->config)
+        : logreg_train_view(e->members[m], &sample, job->config);
+
+    view_release(&sample);
+
+    if (status != 0)
+    {
+        atomic_store(&job->failed, 1);
+        return;
+    }
+
+    memcpy(&e->weights[m * e->num_features], e->members[m]->weights,
+           e->num_features * sizeof(double));
+    e->biases[m] = e->members[m]->bias;
+}
+
+int ml_ensemble_train(MLEnsemble *ensemble,
+                      const DatasetView *data,
+                      const RegressionConfig *config,
+                      unsigned int seed,
+                      ThreadPool *pool)
+{
+    if (!ensemble || !data || !config || data->num_features != ensemble->num_features)
+    {
+        fprintf(stderr, "Invalid arguments passed to ml_ensemble_train.\n");
+        return -1;
+    }
+
+    if (!pool) pool = thread_pool_shared();
+
+    EnsembleJob job = { ensemble, data, config, seed, 0 };
+    atomic_init(&job.failed, 0);
+
+    ensemble->trained = 0;
+
+    if (thread_pool_parallel_for(pool, ensemble->num_members,
+                                 ensemble_train_member, &job) != 0 ||
+        atomic_load(&job.failed))
+    {
+        fprintf(stderr, "Ensemble training failed.\n");
+        return -1;
+    }
+
+    ensemble->trained = 1;
+    return 0;
+}
+
+int ml_ensemble_predict_batch(const MLEnsemble *ensemble,
+                              const DatasetView *data,
+                              double *out)
+{
+    if (!ensemble || !ensemble->trained)
+    {
+        fprintf(stderr, "Ensemble not trained.\n");
+        return -1;
+    }
+
+    if (!data || !data->X || !out || data->num_features != ensemble->num_features)
+        return -1;
+
+    size_t d = ensemble->num_features;
+    size_t members = ensemble->num_members;
+
+    // Each row is loaded once and scored against the packed weight matrix
+    for (size_t i = 0; i < data->num_rows; i++)
+    {
+        const double *row = view_row(data, i);
+        double *out_row = &out[i * members];
+
+        for (size_t m = 0; m < members; m++)
+        {
+            const double *w = &ensemble->weights[m * d];
+            double z = ensemble->biases[m];
+
+            for (size_t j = 0; j < d; j++)
+            {
+                z += w[j] * row[j];
+            }
+
+            out_row[m] = (ensemble->type == ML_LOGISTIC) ? sigmoid(z) : z;
+        }
+    }
+
+    return 0;
+}
+
+int ml_ensemble_predict_mean(const MLEnsemble *ensemble,
+                             const DatasetView *data,
+                             double *mean,
+                             double *variance)
+{
+    if (!ensemble || !data || !mean) return -1;
+
+    size_t members = ensemble->num_members;
+    double *scores = malloc(members * sizeof(double));
+    if (!scores) return -1;
+
+    for (size_t i = 0; i < data->num_rows; i++)
+    {
+        // Score one row at a time through a single-row view
+        DatasetView one = *data;
+        size_t base = view_base_row(data, i);
+        one.rows = &base;
+        one.num_rows = 1;
+        one.owns_rows = 0;
+
+        if (ml_ensemble_predict_batch(ensemble, &one, scores) != 0)
+        {
+            free(scores);
+            return -1;
+        }
+
+        double mu = 0.0;
+        for (size_t m = 0; m < members; m++)
+            mu += scores[m];
+        mu /= members;
+
+        mean[i] = mu;
+
+        if (variance)
+        {
+            double var = 0.0;
+            for (size_t m = 0; m < members; m++)
+                var += (scores[m] - mu) * (scores[m] - mu);
+            variance[i] = var / members;
+        }
+    }
+
+    free(scores);
+    return 0;
+}
+
+size_t ml_ensemble_size(const MLEnsemble *ensemble)
+{
+    return ensemble ? ensemble->num_members : 0;
+}
+
+void ml_ensemble_destroy(MLEnsemble *ensemble)
+{
+    if (!ensemble) return;
+
+    if (ensemble->members)
+    {
+        for (size_t m = 0; m < ensemble->num_members; m++)
+        {
+            if (!ensemble->members[m]) continue;
+
+            if (ensemble->type == ML_LINEAR)
+                linreg_free(ensemble->members[m]);
+            else
+                logreg_free(ensemble->members[m]);
+        }
+    }
+
+    free(ensemble->members);
+    free(ensemble->weights);
+    free(ensemble->biases);
+    free(ensemble);
+}
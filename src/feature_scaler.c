@@ -0,0 +1,168 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "feature_scaler.h"
+
+// Relative variance below which a feature is treated as constant
+#define SCALER_MIN_VARIANCE 1e-24
+
+FeatureScaler *scaler_create(size_t num_features)
+{
+    FeatureScaler *scaler = malloc(sizeof(FeatureScaler));
+    if (!scaler)
+        return NULL;
+
+    scaler->mean = calloc(num_features ? num_features : 1, sizeof(double));
+    scaler->m2 = calloc(num_features ? num_features : 1, sizeof(double));
+
+    if (!scaler->mean || !scaler->m2)
+    {
+        scaler_free(scaler);
+        return NULL;
+    }
+
+    scaler->num_features = num_features;
+    scaler->count = 0;
+    return scaler;
+}
+
+void scaler_update(FeatureScaler *scaler, const double *row)
+{
+    scaler->count++;
+    double inv_count = 1.0 / (double)scaler->count;
+
+    for (size_t j = 0; j < scaler->num_features; j++)
+    {
+        double delta = row[j] - scaler->mean[j];
+        scaler->mean[j] += delta * inv_count;
+        scaler->m2[j] += delta * (row[j] - scaler->mean[j]);
+    }
+}
+
+int scaler_fit_view(FeatureScaler *scaler, const DatasetView *data)
+{
+    if (!scaler || !data || (data->num_rows > 0 && !data->X) ||
+        data->num_features != scaler->num_features)
+        return -1;
+
+    for (size_t i = 0; i < data->num_rows; i++)
+    {
+        scaler_update(scaler, view_row(data, i));
+    }
+
+    return 0;
+}
+
+int scaler_merge_reduced(FeatureScaler *scaler, const GradientReducer *reducer)
+{
+    if (!reducer)
+        return -1;
+
+    size_t d = scaler ? scaler->num_features : 0;
+    double *buf = scaler ? malloc((d + 1) * sizeof(double)) : NULL;
+
+    // Agree on local failures first, so that no worker waits alone below
+    double failed = !buf;
+
+    if (reducer->allreduce(reducer->ctx, &failed, 1) != 0 || failed > 0)
+    {
+        free(buf);
+        return -1;
+    }
+
+    // Pass 1: global count and mean from the per-worker sums
+    double local_count = (double)scaler->count;
+
+    for (size_t j = 0; j < d; j++)
+    {
+        buf[j] = local_count * scaler->mean[j];
+    }
+    buf[d] = local_count;
+
+    if (reducer->allreduce(reducer->ctx, buf, d + 1) != 0 || buf[d] <= 0)
+    {
+        free(buf);
+        return -1;
+    }
+
+    double total = buf[d];
+
+    // Pass 2: M2 = sum over workers of m2_k + n_k * (mean_k - mean)^2
+    for (size_t j = 0; j < d; j++)
+    {
+        double mean = buf[j] / total;
+        double shift = scaler->mean[j] - mean;
+
+        scaler->mean[j] = mean;
+        buf[j] = scaler->m2[j] + local_count * shift * shift;
+    }
+
+    if (reducer->allreduce(reducer->ctx, buf, d) != 0)
+    {
+        free(buf);
+        return -1;
+    }
+
+    for (size_t j = 0; j < d; j++)
+    {
+        scaler->m2[j] = buf[j];
+    }
+
+    scaler->count = (size_t)total;
+
+    free(buf);
+    return 0;
+}
+
+const FeatureScaler *scaler_resolve(const FeatureScaler *given,
+                                    const DatasetView *data,
+                                    const GradientReducer *reducer,
+                                    FeatureScaler **owned)
+{
+    *owned = NULL;
+
+    if (given)
+        return given->num_features == data->num_features ? given : NULL;
+
+    FeatureScaler *scaler = scaler_create(data->num_features);
+
+    if (scaler && scaler_fit_view(scaler, data) != 0)
+    {
+        scaler_free(scaler);
+        scaler = NULL;
+    }
+
+    // A worker that failed locally still joins the merge, as a NULL scaler
+    if ((reducer && scaler_merge_reduced(scaler, reducer) != 0) || !scaler)
+    {
+        scaler_free(scaler);
+        return NULL;
+    }
+
+    *owned = scaler;
+    return scaler;
+}
+
+double scaler_inv_std(const FeatureScaler *scaler, size_t j)
+{
+    if (scaler->count == 0)
+        return 1.0;
+
+    double variance = scaler->m2[j] / (double)scaler->count;
+    double floor = SCALER_MIN_VARIANCE * (1.0 + scaler->mean[j] * scaler->mean[j]);
+
+    if (!(variance > floor))
+        return 1.0;
+
+    return 1.0 / sqrt(variance);
+}
+
+void scaler_free(FeatureScaler *scaler)
+{
+    if (!scaler)
+        return;
+
+    free(scaler->mean);
+    free(scaler->m2);
+    free(scaler);
+}
@@ -0,0 +1,816 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "inference_server.h"
+
+#define SERVE_DEFAULT_BATCH_ROWS 1024
+#define SERVE_DEFAULT_DELAY_US 200
+
+// Latency samples kept for the percentiles
+#define SERVE_LATENCY_WINDOW 65536
+
+#ifdef _WIN32
+
+MLServer *ml_server_create(const char *socket_path, const MLServerConfig *config)
+{
+    (void)socket_path; (void)config;
+    fprintf(stderr, "Inference server is not supported on this platform.\n");
+    return NULL;
+}
+
+int ml_server_register(MLServer *server, const char *name, const MLModel *model)
+{
+    (void)server; (void)name; (void)model;
+    return -1;
+}
+
+int ml_server_start(MLServer *server) { (void)server; return -1; }
+void ml_server_stop(MLServer *server) { (void)server; }
+void ml_server_destroy(MLServer *server) { (void)server; }
+
+int ml_server_get_stats(MLServer *server, MLServerStats *stats)
+{
+    (void)server; (void)stats;
+    return -1;
+}
+
+MLClient *ml_client_connect(const char *socket_path)
+{
+    (void)socket_path;
+    fprintf(stderr, "Inference client is not supported on this platform.\n");
+    return NULL;
+}
+
+int ml_client_predict(MLClient *client, const char *model, const double *x,
+                      size_t num_rows, size_t num_features, double *out)
+{
+    (void)client; (void)model; (void)x; (void)num_rows; (void)num_features; (void)out;
+    return -1;
+}
+
+void ml_client_close(MLClient *client) { (void)client; }
+
+#else
+
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+typedef struct
+{
+    char name[ML_SERVE_MAX_NAME];
+    const MLModel *model;
+    size_t num_features;
+} ServedModel;
+
+typedef struct Connection Connection;
+
+typedef struct ServeRequest
+{
+    struct ServeRequest *next;
+    const ServedModel *entry;
+    const double *x;
+    size_t num_rows;
+    double *out;
+    int status;
+    int done;
+    double enqueue_time;
+    Connection *conn;
+} ServeRequest;
+
+struct Connection
+{
+    Connection *next;
+    MLServer *server;
+    int fd;
+    int finished;
+    pthread_t thread;
+    pthread_cond_t done_cond;     // signalled when the batcher completes its request
+};
+
+struct MLServer
+{
+    MLServerConfig config;
+    struct sockaddr_un addr;
+    int listen_fd;
+    int running;
+    int started;
+
+    ServedModel *models;
+    size_t num_models;
+
+    // Queue of pending requests, guarded by lock
+    pthread_mutex_t lock;
+    pthread_cond_t queue_cond;
+    ServeRequest *head;
+    ServeRequest *tail;
+    size_t pending_rows;
+
+    Connection *connections;
+    pthread_t accept_thread;
+    pthread_t batch_thread;
+
+    // Counters, guarded by stats_lock
+    pthread_mutex_t stats_lock;
+    double start_time;
+    size_t requests;
+    size_t rows;
+    size_t batches;
+    float *latencies;             // microseconds, ring buffer
+    size_t latency_count;
+};
+
+struct MLClient
+{
+    int fd;
+};
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static int send_all(int fd, const void *data, size_t len)
+{
+    const char *p = data;
+
+    while (len > 0)
+    {
+        ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+
+        p += n;
+        len -= (size_t)n;
+    }
+
+    return 0;
+}
+
+static int recv_all(int fd, void *data, size_t len)
+{
+    char *p = data;
+
+    while (len > 0)
+    {
+        ssize_t n = recv(fd, p, len, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+
+        p += n;
+        len -= (size_t)n;
+    }
+
+    return 0;
+}
+
+static int fill_address(struct sockaddr_un *addr, const char *path)
+{
+    if (!path || strlen(path) >= sizeof(addr->sun_path))
+        return -1;
+
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    strcpy(addr->sun_path, path);
+    return 0;
+}
+
+MLServer *ml_server_create(const char *socket_path, const MLServerConfig *config)
+{
+    MLServer *server = calloc(1, sizeof(MLServer));
+    if (!server)
+        return NULL;
+
+    if (fill_address(&server->addr, socket_path) != 0)
+    {
+        fprintf(stderr, "Invalid socket path passed to ml_server_create.\n");
+        free(server);
+        return NULL;
+    }
+
+    server->latencies = malloc(SERVE_LATENCY_WINDOW * sizeof(float));
+    if (!server->latencies)
+    {
+        free(server);
+        return NULL;
+    }
+
+    if (config)
+        server->config = *config;
+    if (server->config.max_batch_rows == 0)
+        server->config.max_batch_rows = SERVE_DEFAULT_BATCH_ROWS;
+    if (server->config.max_delay_us == 0)
+        server->config.max_delay_us = SERVE_DEFAULT_DELAY_US;
+
+    server->listen_fd = -1;
+    pthread_mutex_init(&server->lock, NULL);
+    pthread_cond_init(&server->queue_cond, NULL);
+    pthread_mutex_init(&server->stats_lock, NULL);
+
+    return server;
+}
+
+int ml_server_register(MLServer *server, const char *name, const MLModel *model)
+{
+    if (!server || !name || !model || server->started ||
+        strlen(name) == 0 || strlen(name) >= ML_SERVE_MAX_NAME)
+        return -1;
+
+    for (size_t m = 0; m < server->num_models; m++)
+    {
+        if (strcmp(server->models[m].name, name) == 0)
+        {
+            fprintf(stderr, "Model '%s' is already registered.\n", name);
+            return -1;
+        }
+    }
+
+    ServedModel *models = realloc(server->models, (server->num_models + 1) * sizeof(ServedModel));
+    if (!models)
+        return -1;
+
+    server->models = models;
+
+    ServedModel *entry = &models[server->num_models++];
+    strcpy(entry->name, name);
+    entry->model = model;
+    entry->num_features = ml_num_features(model);
+    return 0;
+}
+
+static const ServedModel *find_model(const MLServer *server, const char *name)
+{
+    for (size_t m = 0; m < server->num_models; m++)
+    {
+        if (strcmp(server->models[m].name, name) == 0)
+            return &server->models[m];
+    }
+
+    return NULL;
+}
+
+static void record_latency(MLServer *server, double seconds, size_t rows)
+{
+    pthread_mutex_lock(&server->stats_lock);
+
+    server->latencies[server->latency_count % SERVE_LATENCY_WINDOW] = (float)(seconds * 1e6);
+    server->latency_count++;
+    server->requests++;
+    server->rows += rows;
+
+    pthread_mutex_unlock(&server->stats_lock);
+}
+
+// Queues the request and blocks until the batcher has scored it
+static int submit_request(MLServer *server, ServeRequest *req)
+{
+    pthread_mutex_lock(&server->lock);
+
+    if (!server->running)
+    {
+        pthread_mutex_unlock(&server->lock);
+        return -1;
+    }
+
+    if (server->tail)
+        server->tail->next = req;
+    else
+        server->head = req;
+
+    server->tail = req;
+    server->pending_rows += req->num_rows;
+    pthread_cond_signal(&server->queue_cond);
+
+    while (!req->done)
+        pthread_cond_wait(&req->conn->done_cond, &server->lock);
+
+    pthread_mutex_unlock(&server->lock);
+    return req->status;
+}
+
+static void *connection_main(void *arg)
+{
+    Connection *conn = arg;
+    MLServer *server = conn->server;
+
+    double *x = NULL;
+    double *out = NULL;
+    size_t capacity_x = 0;
+    size_t capacity_out = 0;
+
+    for (;;)
+    {
+        MLServeRequestHeader hdr;
+        char name[ML_SERVE_MAX_NAME];
+
+        if (recv_all(conn->fd, &hdr, sizeof(hdr)) != 0 || hdr.magic != ML_SERVE_MAGIC ||
+            hdr.name_len == 0 || hdr.name_len >= ML_SERVE_MAX_NAME ||
+            recv_all(conn->fd, name, hdr.name_len) != 0)
+            break;
+
+        name[hdr.name_len] = '\0';
+
+        // Validate against the registry before trusting any size in the header
+        const ServedModel *entry = find_model(server, name);
+        size_t count = (size_t)hdr.num_rows * hdr.num_features;
+
+        if (!entry || entry->num_features != hdr.num_features ||
+            hdr.num_rows > ML_SERVE_MAX_REQUEST_ROWS ||
+            count > ML_SERVE_MAX_REQUEST_BYTES / sizeof(double))
+        {
+            // The unread payload leaves the stream unusable, so close it
+            MLServeResponseHeader resp = { ML_SERVE_MAGIC, -1, 0, 0 };
+            send_all(conn->fd, &resp, sizeof(resp));
+            break;
+        }
+
+        if (count > capacity_x)
+        {
+            double *grown = realloc(x, count * sizeof(double));
+            if (!grown) break;
+            x = grown;
+            capacity_x = count;
+        }
+
+        if (hdr.num_rows > capacity_out)
+        {
+            double *grown = realloc(out, hdr.num_rows * sizeof(double));
+            if (!grown) break;
+            out = grown;
+            capacity_out = hdr.num_rows;
+        }
+
+        if (count > 0 && recv_all(conn->fd, x, count * sizeof(double)) != 0)
+            break;
+
+        double received = now_seconds();
+        int status = 0;
+
+        if (hdr.num_rows > 0)
+        {
+            ServeRequest req = { NULL, entry, x, hdr.num_rows, out, -1, 0, received, conn };
+            status = submit_request(server, &req);
+        }
+
+        MLServeResponseHeader resp = { ML_SERVE_MAGIC, status, status == 0 ? hdr.num_rows : 0, 0 };
+
+        if (send_all(conn->fd, &resp, sizeof(resp)) != 0 ||
+            (resp.num_rows > 0 && send_all(conn->fd, out, resp.num_rows * sizeof(double)) != 0))
+            break;
+
+        if (status == 0)
+            record_latency(server, now_seconds() - received, hdr.num_rows);
+    }
+
+    free(x);
+    free(out);
+
+    // Let the client see end-of-stream now rather than when reaped
+    shutdown(conn->fd, SHUT_RDWR);
+
+    pthread_mutex_lock(&server->lock);
+    conn->finished = 1;
+    pthread_mutex_unlock(&server->lock);
+    return NULL;
+}
+
+static void connection_free(Connection *conn)
+{
+    close(conn->fd);
+    pthread_cond_destroy(&conn->done_cond);
+    free(conn);
+}
+
+// Joins connections whose clients have gone away; called with lock held
+static void reap_connections(MLServer *server)
+{
+    Connection **link = &server->connections;
+
+    while (*link)
+    {
+        Connection *conn = *link;
+
+        if (conn->finished)
+        {
+            *link = conn->next;
+            pthread_join(conn->thread, NULL);
+            connection_free(conn);
+        }
+        else
+        {
+            link = &conn->next;
+        }
+    }
+}
+
+static void *accept_main(void *arg)
+{
+    MLServer *server = arg;
+
+    for (;;)
+    {
+        int fd = accept(server->listen_fd, NULL, NULL);
+
+        if (fd < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            break;
+        }
+
+        pthread_mutex_lock(&server->lock);
+        reap_connections(server);
+
+        Connection *conn = server->running ? calloc(1, sizeof(Connection)) : NULL;
+        if (!conn)
+        {
+            pthread_mutex_unlock(&server->lock);
+            close(fd);
+            continue;
+        }
+
+        conn->server = server;
+        conn->fd = fd;
+        pthread_cond_init(&conn->done_cond, NULL);
+
+        if (pthread_create(&conn->thread, NULL, connection_main, conn) != 0)
+        {
+            pthread_mutex_unlock(&server->lock);
+            connection_free(conn);
+            continue;
+        }
+
+        conn->next = server->connections;
+        server->connections = conn;
+        pthread_mutex_unlock(&server->lock);
+    }
+
+    return NULL;
+}
+
+// Scores one batch: requests are grouped by model, gathered into a
+// contiguous block and passed to ml_predict_view() in one call per model.
+static void score_batch(MLServer *server, ServeRequest *batch,
+                        double **buf_x, double **buf_out, size_t *capacity)
+{
+    for (size_t m = 0; m < server->num_models; m++)
+    {
+        const ServedModel *entry = &server->models[m];
+        size_t d = entry->num_features;
+        size_t total = 0;
+
+        for (ServeRequest *r = batch; r; r = r->next)
+        {
+            if (r->entry == entry)
+                total += r->num_rows;
+        }
+
+        if (total == 0)
+            continue;
+
+        // One buffer size serves both the rows (total * d) and the outputs
+        size_t need = total * (d > 1 ? d : 1);
+
+        if (need > *capacity)
+        {
+            double *grown_x = realloc(*buf_x, need * sizeof(double));
+            if (grown_x) *buf_x = grown_x;
+            double *grown_out = realloc(*buf_out, need * sizeof(double));
+            if (grown_out) *buf_out = grown_out;
+
+            if (!grown_x || !grown_out)
+                continue;
+
+            *capacity = need;
+        }
+
+        size_t offset = 0;
+        for (ServeRequest *r = batch; r; r = r->next)
+        {
+            if (r->entry != entry) continue;
+            memcpy(*buf_x + offset * d, r->x, r->num_rows * d * sizeof(double));
+            offset += r->num_rows;
+        }
+
+        DatasetView view = view_create(*buf_x, NULL, total, d);
+        if (ml_predict_view(entry->model, &view, *buf_out) != 0)
+            continue;
+
+        offset = 0;
+        for (ServeRequest *r = batch; r; r = r->next)
+        {
+            if (r->entry != entry) continue;
+            memcpy(r->out, *buf_out + offset, r->num_rows * sizeof(double));
+            r->status = 0;
+            offset += r->num_rows;
+        }
+    }
+}
+
+static void *batch_main(void *arg)
+{
+    MLServer *server = arg;
+    double *buf_x = NULL;
+    double *buf_out = NULL;
+    size_t capacity = 0;
+    double delay = server->config.max_delay_us * 1e-6;
+
+    pthread_mutex_lock(&server->lock);
+
+    while (server->running || server->head)
+    {
+        if (!server->head)
+        {
+            pthread_cond_wait(&server->queue_cond, &server->lock);
+            continue;
+        }
+
+        double remaining = server->head->enqueue_time + delay - now_seconds();
+
+        if (server->running && server->pending_rows < server->config.max_batch_rows && remaining > 0)
+        {
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+
+            long nsec = deadline.tv_nsec + (long)(remaining * 1e9);
+            deadline.tv_sec += nsec / 1000000000L;
+            deadline.tv_nsec = nsec % 1000000000L;
+
+            pthread_cond_timedwait(&server->queue_cond, &server->lock, &deadline);
+            continue;
+        }
+
+        ServeRequest *batch = server->head;
+        server->head = server->tail = NULL;
+        server->pending_rows = 0;
+
+        pthread_mutex_unlock(&server->lock);
+
+        score_batch(server, batch, &buf_x, &buf_out, &capacity);
+
+        pthread_mutex_lock(&server->stats_lock);
+        server->batches++;
+        pthread_mutex_unlock(&server->stats_lock);
+
+        pthread_mutex_lock(&server->lock);
+
+        for (ServeRequest *r = batch; r;)
+        {
+            ServeRequest *next = r->next;
+            r->done = 1;
+            pthread_cond_signal(&r->conn->done_cond);
+            r = next;
+        }
+    }
+
+    pthread_mutex_unlock(&server->lock);
+
+    free(buf_x);
+    free(buf_out);
+    return NULL;
+}
+
+int ml_server_start(MLServer *server)
+{
+    if (!server || server->started)
+        return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        fprintf(stderr, "Failed to create listening socket.\n");
+        return -1;
+    }
+
+    unlink(server->addr.sun_path);
+
+    if (bind(fd, (struct sockaddr *)&server->addr, sizeof(server->addr)) != 0 ||
+        listen(fd, 128) != 0)
+    {
+        fprintf(stderr, "Failed to listen on %s: %s\n", server->addr.sun_path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    server->listen_fd = fd;
+    server->running = 1;
+    server->start_time = now_seconds();
+
+    if (pthread_create(&server->batch_thread, NULL, batch_main, server) != 0)
+    {
+        server->running = 0;
+        close(fd);
+        server->listen_fd = -1;
+        return -1;
+    }
+
+    if (pthread_create(&server->accept_thread, NULL, accept_main, server) != 0)
+    {
+        pthread_mutex_lock(&server->lock);
+        server->running = 0;
+        pthread_cond_broadcast(&server->queue_cond);
+        pthread_mutex_unlock(&server->lock);
+
+        pthread_join(server->batch_thread, NULL);
+        close(fd);
+        server->listen_fd = -1;
+        return -1;
+    }
+
+    server->started = 1;
+    return 0;
+}
+
+void ml_server_stop(MLServer *server)
+{
+    if (!server || !server->started)
+        return;
+
+    pthread_mutex_lock(&server->lock);
+    server->running = 0;
+    pthread_cond_broadcast(&server->queue_cond);
+    pthread_mutex_unlock(&server->lock);
+
+    // Wake the accept loop, then every connection blocked in recv()
+    shutdown(server->listen_fd, SHUT_RDWR);
+    pthread_join(server->accept_thread, NULL);
+
+    pthread_mutex_lock(&server->lock);
+    for (Connection *conn = server->connections; conn; conn = conn->next)
+        shutdown(conn->fd, SHUT_RDWR);
+    pthread_mutex_unlock(&server->lock);
+
+    for (Connection *conn = server->connections; conn;)
+    {
+        Connection *next = conn->next;
+        pthread_join(conn->thread, NULL);
+        connection_free(conn);
+        conn = next;
+    }
+
+    server->connections = NULL;
+    pthread_join(server->batch_thread, NULL);
+
+    close(server->listen_fd);
+    server->listen_fd = -1;
+    server->started = 0;
+}
+
+static int compare_float(const void *a, const void *b)
+{
+    float fa = *(const float *)a;
+    float fb = *(const float *)b;
+    return (fa > fb) - (fa < fb);
+}
+
+int ml_server_get_stats(MLServer *server, MLServerStats *stats)
+{
+    if (!server || !stats)
+        return -1;
+
+    memset(stats, 0, sizeof(*stats));
+
+    float *sorted = malloc(SERVE_LATENCY_WINDOW * sizeof(float));
+    if (!sorted)
+        return -1;
+
+    pthread_mutex_lock(&server->stats_lock);
+
+    size_t samples = server->latency_count < SERVE_LATENCY_WINDOW ?
+                     server->latency_count : SERVE_LATENCY_WINDOW;
+    memcpy(sorted, server->latencies, samples * sizeof(float));
+
+    stats->requests = server->requests;
+    stats->rows = server->rows;
+    stats->batches = server->batches;
+
+    pthread_mutex_unlock(&server->stats_lock);
+
+    if (samples > 0)
+    {
+        qsort(sorted, samples, sizeof(float), compare_float);
+        stats->p50_latency_us = sorted[(samples - 1) / 2];
+        stats->p99_latency_us = sorted[(size_t)((double)(samples - 1) * 0.99)];
+    }
+
+    free(sorted);
+
+    if (stats->batches > 0)
+        stats->mean_batch_rows = (double)stats->rows / (double)stats->batches;
+
+    if (server->start_time > 0)
+    {
+        stats->uptime_seconds = now_seconds() - server->start_time;
+
+        if (stats->uptime_seconds > 0)
+        {
+            stats->requests_per_second = (double)stats->requests / stats->uptime_seconds;
+            stats->rows_per_second = (double)stats->rows / stats->uptime_seconds;
+        }
+    }
+
+    return 0;
+}
+
+void ml_server_destroy(MLServer *server)
+{
+    if (!server)
+        return;
+
+    ml_server_stop(server);
+
+    if (server->start_time > 0)
+        unlink(server->addr.sun_path);
+
+    pthread_mutex_destroy(&server->lock);
+    pthread_cond_destroy(&server->queue_cond);
+    pthread_mutex_destroy(&server->stats_lock);
+
+    free(server->latencies);
+    free(server->models);
+    free(server);
+}
+
+MLClient *ml_client_connect(const char *socket_path)
+{
+    struct sockaddr_un addr;
+
+    if (fill_address(&addr, socket_path) != 0)
+    {
+        fprintf(stderr, "Invalid socket path passed to ml_client_connect.\n");
+        return NULL;
+    }
+
+    MLClient *client = malloc(sizeof(MLClient));
+    if (!client)
+        return NULL;
+
+    client->fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (client->fd < 0 || connect(client->fd, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+    {
+        fprintf(stderr, "Failed to connect to %s: %s\n", socket_path, strerror(errno));
+        if (client->fd >= 0) close(client->fd);
+        free(client);
+        return NULL;
+    }
+
+    return client;
+}
+
+int ml_client_predict(MLClient *client, const char *model, const double *x,
+                      size_t num_rows, size_t num_features, double *out)
+{
+    if (!client || !model || (num_rows > 0 && (!x || !out)))
+        return -1;
+
+    size_t name_len = strlen(model);
+
+    if (name_len == 0 || name_len >= ML_SERVE_MAX_NAME ||
+        num_rows > ML_SERVE_MAX_REQUEST_ROWS || num_features > UINT32_MAX ||
+        (num_features > 0 && num_rows > ML_SERVE_MAX_REQUEST_BYTES / sizeof(double) / num_features))
+        return -1;
+
+    MLServeRequestHeader hdr = { ML_SERVE_MAGIC, (uint32_t)name_len,
+                                 (uint32_t)num_rows, (uint32_t)num_features };
+    MLServeResponseHeader resp;
+
+    if (send_all(client->fd, &hdr, sizeof(hdr)) != 0 ||
+        send_all(client->fd, model, name_len) != 0 ||
+        (num_rows > 0 && send_all(client->fd, x, num_rows * num_features * sizeof(double)) != 0) ||
+        recv_all(client->fd, &resp, sizeof(resp)) != 0 ||
+        resp.magic != ML_SERVE_MAGIC)
+        return -1;
+
+    if (resp.status != 0)
+        return -1;
+
+    if (resp.num_rows != num_rows)
+        return -1;
+
+    if (num_rows > 0 && recv_all(client->fd, out, num_rows * sizeof(double)) != 0)
+        return -1;
+
+    return 0;
+}
+
+void ml_client_close(MLClient *client)
+{
+    if (!client)
+        return;
+
+    close(client->fd);
+    free(client);
+}
+
+#endif
@@ -5,6 +5,97 @@
 #include <stdlib.h>
 #include <string.h>
 #include "linear_reg.h"
+#include "utils.h"
+#include "coordinate_descent.h"
+#include "ml_stats.h"
+#include "block_reduce.h"
+#include "step_rule.h"
+#include "feature_scaler.h"
+
+typedef struct
+{
+    const RegressionModel *model;
+    const DatasetView *data;
+    const size_t *loss_rows;
+    bool full_loss;
+} LinregPass;
+
+// partial = [dw (d), db, loss] over rows [begin, end)
+static void linreg_gradient_block(void *ctx, size_t begin, size_t end, double *partial)
+{
+    const LinregPass *pass = ctx;
+    const RegressionModel *model = pass->model;
+    size_t d = model->num_features;
+
+    for (size_t i = begin; i < end; i++)
+    {
+        const double *row = view_row(pass->data, i);
+        double y_pred = model->bias;
+
+        for (size_t j = 0; j < d; j++)
+        {
+            y_pred += model->weights[j] * row[j];
+        }
+
+        double error = y_pred - view_target(pass->data, i);
+
+        for (size_t j = 0; j < d; j++)
+        {
+            partial[j] += error * row[j];
+        }
+
+        partial[d] += error;
+        if (pass->full_loss)
+            partial[d + 1] += error * error;
+    }
+}
+
+// partial[0] = squared error over loss rows [begin, end) (all rows if loss_rows is NULL)
+static void linreg_loss_block(void *ctx, size_t begin, size_t end, double *partial)
+{
+    const LinregPass *pass = ctx;
+    const RegressionModel *model = pass->model;
+
+    for (size_t s = begin; s < end; s++)
+    {
+        size_t i = pass->loss_rows ? pass->loss_rows[s] : s;
+
+        const double *row = view_row(pass->data, i);
+        double y_pred = model->bias;
+
+        for (size_t j = 0; j < model->num_features; j++)
+        {
+            y_pred += model->weights[j] * row[j];
+        }
+
+        double error = y_pred - view_target(pass->data, i);
+        partial[0] += error * error;
+    }
+}
+
+typedef struct
+{
+    BlockReducer *rows;
+    LinregPass pass;
+    const GradientReducer *reducer;
+    double total_samples;
+} LinregLossEval;
+
+// Mean squared loss over all rows, for the line search
+static double linreg_mean_loss(void *ctx)
+{
+    LinregLossEval *eval = ctx;
+    double loss = 0.0;
+
+    // On failure NAN is still reduced, so every rank sees it
+    if (block_reducer_run(eval->rows, 1, linreg_loss_block, &eval->pass, &loss) != 0)
+        loss = NAN;
+
+    if (eval->reducer && eval->reducer->allreduce(eval->reducer->ctx, &loss, 1) != 0)
+        return NAN;
+
+    return loss / (2 * eval->total_samples);
+}
 
 RegressionModel *linreg_create(size_t num_features)
 {
@@ -43,13 +134,35 @@ int linreg_train(RegressionModel *model, const double *x, const double *y, const
         return -1;
     }
 
-    if (num_samples < 2)
+    DatasetView data = view_create(x, y, num_samples, model->num_features);
+    return linreg_train_view(model, &data, config);
+}
+
+int linreg_train_view(RegressionModel *model, const DatasetView *data, const RegressionConfig *config)
+{
+    return linreg_train_reduced(model, data, config, NULL);
+}
+
+int linreg_train_reduced(RegressionModel *model, const DatasetView *data, const RegressionConfig *config,
+                         const GradientReducer *reducer)
+{
+    if (model == NULL || data == NULL ||
+        (data->num_rows > 0 && (data->X == NULL || data->y == NULL)))
+    {
+        fprintf(stderr, "Null pointer passed to linreg_train.\n");
+        return -1;
+    }
+
+    size_t num_samples = data->num_rows;
+
+    // A shard may be empty; the 2-row minimum applies to the total
+    if (!reducer && num_samples < 2)
     {
         fprintf(stderr, "Error: Need at least 2 data points for regression.\n");
         return -1;
     }
 
-    if (!model->weights)
+    if (!model->weights || data->num_features != model->num_features)
     {
         fprintf(stderr, "Model weights not initialized properly.\n");
         return -1;
@@ -60,63 +173,516 @@ int linreg_train(RegressionModel *model, const double *x, const double *y, const
         return -1;
     }
 
+    if (config->solver == REG_SOLVER_CD)
+    {
+        if (reducer)
+        {
+            fprintf(stderr, "Coordinate descent does not support gradient reduction.\n");
+            return -1;
+        }
+        if (config->standardize)
+        {
+            fprintf(stderr, "Coordinate descent does not support standardize.\n");
+            return -1;
+        }
+        return linreg_train_cd(model, data, config);
+    }
+
     model->trained = 0;
 
-    double *dw = calloc(model->num_features, sizeof(double));
+    size_t d = model->num_features;
 
-    if (!dw)
+    // dw followed by db, the loss and a failure flag, so one reduction covers all four
+    double *dw = calloc(d + 3, sizeof(double));
+
+    // Optional fixed subsample used only for the early-stopping loss
+    size_t *loss_rows = NULL;
+    size_t loss_count = num_samples;
+
+    if (config->loss_sample_size > 0 && config->loss_sample_size < num_samples)
+    {
+        loss_count = config->loss_sample_size;
+        loss_rows = sample_indices(num_samples, loss_count, config->loss_sample_seed);
+    }
+
+    // Standardization statistics, fitted here unless the caller supplied them
+    FeatureScaler *owned_scaler = NULL;
+    const FeatureScaler *scaler = NULL;
+
+    if (config->standardize)
+        scaler = scaler_resolve(config->scaler, data, reducer, &owned_scaler);
+
+    BlockReducer *grad_reducer = block_reducer_create(num_samples, d + 2, config->num_threads,
+                                                      config->reproducible, config->numa);
+    // Sampled loss rows are scattered over the data, so NUMA grouping buys nothing there
+    BlockReducer *loss_reducer = block_reducer_create(loss_count, 1, config->num_threads,
+                                                      config->reproducible, 0);
+    StepRule *step = config->standardize && !scaler ? NULL : step_rule_create(model, config, scaler);
+
+    int failed = 0;
+
+    if (config->standardize && !scaler)
+    {
+        fprintf(stderr, "Feature scaling failed.\n");
+        failed = 1;
+    }
+    else if (!dw || (loss_count < num_samples && !loss_rows) || !grad_reducer || !loss_reducer || !step)
     {
         fprintf(stderr, "Memory Allocation failed.\n");
+        failed = 1;
+    }
+
+    double total_samples = (double)num_samples;
+    double total_loss_count = (double)loss_count;
+
+    // Every rank joins this reduction, even after a local failure, so that
+    // all of them give up together instead of leaving peers waiting
+    if (reducer)
+    {
+        double counts[3] = { total_samples, total_loss_count, (double)failed };
+
+        if (reducer->allreduce(reducer->ctx, counts, 3) != 0)
+        {
+            fprintf(stderr, "Gradient reduction failed.\n");
+            failed = 1;
+        }
+        else
+        {
+            total_samples = counts[0];
+            total_loss_count = counts[1];
+            failed = counts[2] > 0;
+        }
+    }
+
+    if (failed || total_samples < 2)
+    {
+        if (!failed)
+            fprintf(stderr, "Error: Need at least 2 data points for regression.\n");
+
+        block_reducer_free(grad_reducer);
+        block_reducer_free(loss_reducer);
+        step_rule_free(step);
+        scaler_free(owned_scaler);
+        free(loss_rows);
+        free(dw);
         return -1;
     }
 
+    LinregPass pass = { model, data, loss_rows, false };
+    LinregLossEval loss_eval = { grad_reducer, { model, data, NULL, false }, reducer, total_samples };
+
+    size_t patience = config->patience ? config->patience : 1;
+    size_t stalled_checks = 0;
     double prev_loss = DBL_MAX;
+    int status = 0;
 
     model->stopping_iteration = config->num_iterations;
 
+    ML_STATS_START(train_start);
+    ML_STATS_HW_BEGIN(hw);
+    ML_STATS_COUNT(ML_STAT_TRAIN_CALLS, 1);
+
     for (size_t iter = 0; iter < config->num_iterations; iter++)
     {
+        // A stop request or failed pass is still reduced, flagged, so every
+        // rank leaves the loop at the same iteration
+        int stop = config->should_stop && config->should_stop(config->stop_ctx);
+
+        bool check = is_loss_check(iter, config->loss_check_interval);
+        pass.full_loss = check && !loss_rows;
+
+        ML_STATS_COUNT(ML_STAT_ITERATIONS, 1);
+        ML_STATS_COUNT(ML_STAT_ROWS_PROCESSED, num_samples);
+        ML_STATS_START(gradient_start);
+
+        int pass_failed = !stop && block_reducer_run(grad_reducer, d + 2, linreg_gradient_block,
+                                                     &pass, dw) != 0;
+
+        ML_STATS_STOP(ML_STAT_GRADIENT_NS, gradient_start);
+        ML_STATS_START(loss_start);
+
+        if (check && loss_rows && !stop && !pass_failed)
+        {
+            double sampled_loss = 0.0;
+
+            pass_failed = block_reducer_run(loss_reducer, 1, linreg_loss_block, &pass, &sampled_loss) != 0;
+            dw[d + 1] = sampled_loss;
+        }
+
+        dw[d + 2] = stop || pass_failed;
+
+        if (reducer && reducer->allreduce(reducer->ctx, dw, d + 3) != 0)
+        {
+            fprintf(stderr, "Gradient reduction failed.\n");
+            ML_STATS_STOP(ML_STAT_LOSS_NS, loss_start);
+            status = -1;
+            break;
+        }
+
+        if (dw[d + 2] > 0)
+        {
+            ML_STATS_STOP(ML_STAT_LOSS_NS, loss_start);
+            status = -1;
+            break;
+        }
+
+        double curr_loss = dw[d + 1];
+
+        if (check)
+        {
+            curr_loss /= (2 * total_loss_count);
+            curr_loss += step_rule_penalty(step, model);
+            if (prev_loss > 0 && fabs(prev_loss - curr_loss) / prev_loss < config->early_stopping_threshold)
+            {
+                if (++stalled_checks >= patience)
+                {
+                    model->stopping_iteration = iter;
+                    ML_STATS_STOP(ML_STAT_LOSS_NS, loss_start);
+                    break;
+                }
+            }
+            else
+            {
+                stalled_checks = 0;
+            }
+
+            prev_loss = curr_loss;
+        }
+
+        ML_STATS_STOP(ML_STAT_LOSS_NS, loss_start);
+        ML_STATS_START(update_start);
+
+        if (step_rule_update(step, model, dw, total_samples, linreg_mean_loss, &loss_eval) != 0)
+        {
+            ML_STATS_STOP(ML_STAT_UPDATE_NS, update_start);
+            status = -1;
+            break;
+        }
+
+        ML_STATS_STOP(ML_STAT_UPDATE_NS, update_start);
+    }
+
+    ML_STATS_HW_END(hw);
+    ML_STATS_STOP(ML_STAT_TRAIN_NS, train_start);
+
+    step_rule_finish(step, model);
+    step_rule_free(step);
+    block_reducer_free(grad_reducer);
+    block_reducer_free(loss_reducer);
+    scaler_free(owned_scaler);
+    free(loss_rows);
+    free(dw);
+
+    if (status != 0)
+        return status;
+
+    model->trained = 1;
+    return 0;
+}
+
+LinRegStats *linreg_stats_create(size_t num_features)
+{
+    LinRegStats *stats = malloc(sizeof(LinRegStats));
+    if (!stats)
+        return NULL;
+
+    stats->xtx = calloc(num_features * num_features, sizeof(double));
+    stats->xty = calloc(num_features, sizeof(double));
+    stats->x_sum = calloc(num_features, sizeof(double));
+
+    if (!stats->xtx || !stats->xty || !stats->x_sum)
+    {
+        linreg_stats_free(stats);
+        return NULL;
+    }
+
+    stats->num_features = num_features;
+    stats->num_samples = 0;
+    stats->y_sum = 0.0;
+    stats->yty = 0.0;
+    return stats;
+}
+
+void linreg_stats_free(LinRegStats *stats)
+{
+    if (!stats)
+        return;
+
+    free(stats->xtx);
+    free(stats->xty);
+    free(stats->x_sum);
+    free(stats);
+}
+
+int linreg_stats_accumulate(LinRegStats *stats, const double *x, const double *y, size_t num_samples)
+{
+    if (stats == NULL || x == NULL || y == NULL)
+    {
+        fprintf(stderr, "Null pointer passed to linreg_stats_accumulate.\n");
+        return -1;
+    }
+
+    size_t d = stats->num_features;
 
-        memset(dw, 0, model->num_features * sizeof(double));
-        double db = 0.0;
-        double curr_loss = 0.0;
+    for (size_t i = 0; i < num_samples; i++)
+    {
+        const double *row = &x[i * d];
 
-        for (size_t i = 0; i < num_samples; i++)
+        // Upper triangle only; mirrored once after the pass
+        for (size_t j = 0; j < d; j++)
         {
-            double y_pred = model->bias;
+            double xj = row[j];
+            double *xtx_row = &stats->xtx[j * d];
 
-            for (size_t j = 0; j < model->num_features; j++)
+            for (size_t k = j; k < d; k++)
             {
-                y_pred += model->weights[j] * x[i * model->num_features + j];
+                xtx_row[k] += xj * row[k];
             }
 
-            double error = y_pred - y[i];
+            stats->xty[j] += xj * y[i];
+            stats->x_sum[j] += xj;
+        }
+
+        stats->y_sum += y[i];
+        stats->yty += y[i] * y[i];
+    }
+
+    for (size_t j = 0; j < d; j++)
+    {
+        for (size_t k = j + 1; k < d; k++)
+        {
+            stats->xtx[k * d + j] = stats->xtx[j * d + k];
+        }
+    }
+
+    stats->num_samples += num_samples;
+    return 0;
+}
+
+int linreg_stats_merge(LinRegStats *dst, const LinRegStats *src)
+{
+    if (dst == NULL || src == NULL || dst->num_features != src->num_features)
+    {
+        fprintf(stderr, "Incompatible statistics passed to linreg_stats_merge.\n");
+        return -1;
+    }
+
+    size_t d = dst->num_features;
+
+    for (size_t j = 0; j < d * d; j++)
+    {
+        dst->xtx[j] += src->xtx[j];
+    }
+
+    for (size_t j = 0; j < d; j++)
+    {
+        dst->xty[j] += src->xty[j];
+        dst->x_sum[j] += src->x_sum[j];
+    }
+
+    dst->y_sum += src->y_sum;
+    dst->yty += src->yty;
+    dst->num_samples += src->num_samples;
+    return 0;
+}
+
+typedef struct
+{
+    const RegressionModel *model;
+    const LinRegStats *stats;
+} StatsLossEval;
+
+// Mean squared loss from the sufficient statistics, O(d^2)
+static double linreg_stats_mean_loss(void *ctx)
+{
+    const StatsLossEval *eval = ctx;
+    const RegressionModel *model = eval->model;
+    const LinRegStats *stats = eval->stats;
+    size_t d = stats->num_features;
+    double n = (double)stats->num_samples;
+    double b = model->bias;
+    double sum_xw = 0.0;
+    double wty = 0.0;
+    double wtxtxw = 0.0;
+
+    for (size_t j = 0; j < d; j++)
+    {
+        const double *xtx_row = &stats->xtx[j * d];
+        double g = 0.0;
+
+        for (size_t k = 0; k < d; k++)
+        {
+            g += xtx_row[k] * model->weights[k];
+        }
+
+        wtxtxw += model->weights[j] * g;
+        sum_xw += stats->x_sum[j] * model->weights[j];
+        wty += model->weights[j] * stats->xty[j];
+    }
+
+    double sse = wtxtxw + 2.0 * b * sum_xw - 2.0 * wty
+               + n * b * b - 2.0 * b * stats->y_sum + stats->yty;
+    return fmax(sse, 0.0) / (2 * n);
+}
+
+int linreg_train_stats(RegressionModel *model, const LinRegStats *stats, const RegressionConfig *config)
+{
+    if (model == NULL || stats == NULL)
+    {
+        fprintf(stderr, "Null pointer passed to linreg_train_stats.\n");
+        return -1;
+    }
+
+    if (stats->num_samples < 2)
+    {
+        fprintf(stderr, "Error: Need at least 2 data points for regression.\n");
+        return -1;
+    }
+
+    if (!model->weights || model->num_features != stats->num_features)
+    {
+        fprintf(stderr, "Model weights not initialized properly.\n");
+        return -1;
+    }
+    if (!config)
+    {
+        fprintf(stderr, "Null config passed.\n");
+        return -1;
+    }
+
+    model->trained = 0;
+
+    size_t d = model->num_features;
+    double n = (double)stats->num_samples;
+
+    // Standardization statistics come straight from the moments:
+    // mean = x_sum / n, m2 = xtx_jj - n * mean^2
+    FeatureScaler *owned_scaler = NULL;
+    const FeatureScaler *scaler = config->standardize ? config->scaler : NULL;
 
-            for (size_t j = 0; j < model->num_features; j++)
+    if (config->standardize && !scaler)
+    {
+        owned_scaler = scaler_create(d);
+
+        if (owned_scaler)
+        {
+            for (size_t j = 0; j < d; j++)
             {
-                dw[j] += error * x[i * model->num_features + j];
+                double mean = stats->x_sum[j] / n;
+
+                owned_scaler->mean[j] = mean;
+                owned_scaler->m2[j] = fmax(stats->xtx[j * d + j] - n * mean * mean, 0.0);
             }
 
-            db += error;
-            curr_loss += error * error;
+            owned_scaler->count = stats->num_samples;
         }
-        curr_loss /= (2 * num_samples);
-        if (prev_loss > 0 && fabs(prev_loss - curr_loss) / prev_loss < config->early_stopping_threshold)
+
+        scaler = owned_scaler;
+    }
+
+    // dw followed by db, the layout step_rule_update() expects
+    double *dw = calloc(d + 1, sizeof(double));
+    StepRule *step = (!config->standardize || scaler) ? step_rule_create(model, config, scaler) : NULL;
+    StatsLossEval loss_eval = { model, stats };
+
+    if (!dw || !step)
+    {
+        fprintf(stderr, "Memory Allocation failed.\n");
+        free(dw);
+        step_rule_free(step);
+        scaler_free(owned_scaler);
+        return -1;
+    }
+
+    int status = 0;
+
+    size_t patience = config->patience ? config->patience : 1;
+    size_t stalled_checks = 0;
+    double prev_loss = DBL_MAX;
+
+    model->stopping_iteration = config->num_iterations;
+
+    ML_STATS_START(train_start);
+    ML_STATS_COUNT(ML_STAT_TRAIN_CALLS, 1);
+
+    for (size_t iter = 0; iter < config->num_iterations; iter++)
+    {
+        if (config->should_stop && config->should_stop(config->stop_ctx))
         {
-            model->stopping_iteration = iter;
+            status = -1;
             break;
         }
 
-        for (size_t j = 0; j < model->num_features; j++)
+        ML_STATS_COUNT(ML_STAT_ITERATIONS, 1);
+
+        double b = model->bias;
+        double sum_xw = 0.0;  // x_sum . w
+        double wty = 0.0;     // w . X^T y
+        double wtxtxw = 0.0;  // w^T X^T X w
+
+        // dw = X^T X w + b * x_sum - X^T y
+        for (size_t j = 0; j < d; j++)
         {
-            model->weights[j] -= config->learning_rate * (dw[j] / num_samples);
+            const double *xtx_row = &stats->xtx[j * d];
+            double g = 0.0;
+
+            for (size_t k = 0; k < d; k++)
+            {
+                g += xtx_row[k] * model->weights[k];
+            }
+
+            wtxtxw += model->weights[j] * g;
+            sum_xw += stats->x_sum[j] * model->weights[j];
+            wty += model->weights[j] * stats->xty[j];
+
+            dw[j] = g + b * stats->x_sum[j] - stats->xty[j];
         }
 
-        model->bias -= config->learning_rate * (db / num_samples);
+        // db = x_sum . w + n * b - y_sum
+        dw[d] = sum_xw + n * b - stats->y_sum;
 
-        prev_loss = curr_loss;
+        // Loss is already O(d), so only the interval and patience apply here
+        if (is_loss_check(iter, config->loss_check_interval))
+        {
+            // sum of squared errors, expanded
+            double sse = wtxtxw + 2.0 * b * sum_xw - 2.0 * wty
+                       + n * b * b - 2.0 * b * stats->y_sum + stats->yty;
+            double curr_loss = fmax(sse, 0.0) / (2 * n)
+                             + step_rule_penalty(step, model);
+
+            if (prev_loss > 0 && fabs(prev_loss - curr_loss) / prev_loss < config->early_stopping_threshold)
+            {
+                if (++stalled_checks >= patience)
+                {
+                    model->stopping_iteration = iter;
+                    break;
+                }
+            }
+            else
+            {
+                stalled_checks = 0;
+            }
+
+            prev_loss = curr_loss;
+        }
+
+        if (step_rule_update(step, model, dw, n, linreg_stats_mean_loss, &loss_eval) != 0)
+        {
+            status = -1;
+            break;
+        }
     }
+
+    ML_STATS_STOP(ML_STAT_TRAIN_NS, train_start);
+
+    step_rule_finish(step, model);
+    step_rule_free(step);
+    scaler_free(owned_scaler);
     free(dw);
+
+    if (status != 0)
+        return status;
+
     model->trained = 1;
     return 0;
 }
@@ -145,3 +711,33 @@ double linreg_predict(RegressionModel *model, const double *x)
 
     return y_pred;
 }
+
+int linreg_predict_view(const RegressionModel *model, const DatasetView *data, double *out)
+{
+    if (model == NULL || !model->trained)
+    {
+        fprintf(stderr, "Model not trained.\n");
+        return -1;
+    }
+
+    if (!data || !data->X || !out || data->num_features != model->num_features)
+    {
+        fprintf(stderr, "Invalid data passed to linreg_predict_view.\n");
+        return -1;
+    }
+
+    for (size_t i = 0; i < data->num_rows; i++)
+    {
+        const double *row = view_row(data, i);
+        double y_pred = model->bias;
+
+        for (size_t j = 0; j < model->num_features; j++)
+        {
+            y_pred += model->weights[j] * row[j];
+        }
+
+        out[i] = y_pred;
+    }
+
+    return 0;
+}
@@ -7,6 +7,12 @@
 static const double LOGREG_EPSILON = 1e-15;
 
 #include "logistic_reg.h"
+#include "utils.h"
+#include "coordinate_descent.h"
+#include "ml_stats.h"
+#include "block_reduce.h"
+#include "step_rule.h"
+#include "feature_scaler.h"
 
 RegressionModel *logreg_create(size_t num_features)
 {
@@ -49,6 +55,90 @@ double sigmoid(double z)
     }
 }
 
+typedef struct
+{
+    const RegressionModel *model;
+    const DatasetView *data;
+    const size_t *loss_rows;
+} LogregPass;
+
+// partial = [dw (d), db] over rows [begin, end)
+static void logreg_gradient_block(void *ctx, size_t begin, size_t end, double *partial)
+{
+    const LogregPass *pass = ctx;
+    const RegressionModel *model = pass->model;
+    size_t d = model->num_features;
+
+    for (size_t i = begin; i < end; i++)
+    {
+
+        const double *row = view_row(pass->data, i);
+        double z = model->bias;
+
+        for (size_t j = 0; j < d; j++)
+        {
+            z += model->weights[j] * row[j];
+        }
+
+        double p = sigmoid(z);
+        double err = p - view_target(pass->data, i);
+
+        for (size_t j = 0; j < d; j++)
+        {
+            partial[j] += err * row[j];
+        }
+
+        partial[d] += err;
+    }
+}
+
+// partial[0] = cross-entropy over loss rows [begin, end)
+static void logreg_loss_block(void *ctx, size_t begin, size_t end, double *partial)
+{
+    const LogregPass *pass = ctx;
+    const RegressionModel *model = pass->model;
+
+    for (size_t s = begin; s < end; s++)
+    {
+        size_t i = pass->loss_rows ? pass->loss_rows[s] : s;
+
+        const double *row = view_row(pass->data, i);
+        double z = model->bias;
+
+        for (size_t j = 0; j < model->num_features; j++)
+        {
+            z += model->weights[j] * row[j];
+        }
+
+        double p = sigmoid(z);
+        partial[0] += binary_cross_entropy(p, view_target(pass->data, i));
+    }
+}
+
+typedef struct
+{
+    BlockReducer *rows;
+    LogregPass pass;
+    const GradientReducer *reducer;
+    double total_samples;
+} LogregLossEval;
+
+// Mean cross-entropy over all rows, for the line search
+static double logreg_mean_loss(void *ctx)
+{
+    LogregLossEval *eval = ctx;
+    double loss = 0.0;
+
+    // On failure NAN is still reduced, so every rank sees it
+    if (block_reducer_run(eval->rows, 1, logreg_loss_block, &eval->pass, &loss) != 0)
+        loss = NAN;
+
+    if (eval->reducer && eval->reducer->allreduce(eval->reducer->ctx, &loss, 1) != 0)
+        return NAN;
+
+    return loss / eval->total_samples;
+}
+
 void logreg_free(RegressionModel *model)
 {
     if (!model)
@@ -64,89 +154,228 @@ int logreg_train(RegressionModel *model, const double *X, const double *y, size_
     if (!model || !X || !y || num_samples == 0)
         return -1;
 
+    DatasetView data = view_create(X, y, num_samples, model->num_features);
+    return logreg_train_view(model, &data, config);
+}
+
+int logreg_train_view(RegressionModel *model, const DatasetView *data, const RegressionConfig *config)
+{
+    return logreg_train_reduced(model, data, config, NULL);
+}
+
+int logreg_train_reduced(RegressionModel *model, const DatasetView *data, const RegressionConfig *config,
+                         const GradientReducer *reducer)
+{
+
+    // A shard may be empty; only the total has to be non-zero
+    if (!model || !data || (data->num_rows > 0 && (!data->X || !data->y)) ||
+        (!reducer && data->num_rows == 0) ||
+        data->num_features != model->num_features)
+        return -1;
+
+    size_t num_samples = data->num_rows;
+
     if (!config)
     {
         fprintf(stderr, "Null config passed.\n");
         return -1;
     }
 
+    if (config->solver == REG_SOLVER_CD)
+    {
+        if (reducer)
+        {
+            fprintf(stderr, "Coordinate descent does not support gradient reduction.\n");
+            return -1;
+        }
+        if (config->standardize)
+        {
+            fprintf(stderr, "Coordinate descent does not support standardize.\n");
+            return -1;
+        }
+        return logreg_train_cd(model, data, config);
+    }
+
+    size_t d = model->num_features;
     double prev_loss = DBL_MAX;
-    double *dw = calloc(model->num_features, sizeof(double));
-    if (!dw)
-        return -1;
 
-    model->trained = 0;
-    model->stopping_iteration = config->num_iterations;
+    // dw followed by db and a failure flag, so one reduction covers all three
+    double *dw = calloc(d + 2, sizeof(double));
 
-    for (size_t iter = 0; iter < config->num_iterations; iter++)
+    // Optional fixed subsample used only for the early-stopping loss
+    size_t *loss_rows = NULL;
+    size_t loss_count = num_samples;
+
+    if (config->loss_sample_size > 0 && config->loss_sample_size < num_samples)
     {
+        loss_count = config->loss_sample_size;
+        loss_rows = sample_indices(num_samples, loss_count, config->loss_sample_seed);
+    }
+
+    // Standardization statistics, fitted here unless the caller supplied them
+    FeatureScaler *owned_scaler = NULL;
+    const FeatureScaler *scaler = NULL;
+
+    if (config->standardize)
+        scaler = scaler_resolve(config->scaler, data, reducer, &owned_scaler);
+
+    BlockReducer *grad_reducer = block_reducer_create(num_samples, d + 1, config->num_threads,
+                                                      config->reproducible, config->numa);
+    // Sampled loss rows are scattered over the data, so NUMA grouping buys nothing there
+    BlockReducer *loss_reducer = block_reducer_create(loss_count, 1, config->num_threads,
+                                                      config->reproducible, 0);
+    StepRule *step = config->standardize && !scaler ? NULL : step_rule_create(model, config, scaler);
 
-        memset(dw, 0, model->num_features * sizeof(double));
+    int failed = (config->standardize && !scaler) || !dw ||
+                 (loss_count < num_samples && !loss_rows) ||
+                 !grad_reducer || !loss_reducer || !step;
 
-        double db = 0.0;
+    double total_samples = (double)num_samples;
+    double total_loss_count = (double)loss_count;
 
-        for (size_t i = 0; i < num_samples; i++)
+    // Every rank joins this reduction, even after a local failure, so that
+    // all of them give up together instead of leaving peers waiting
+    if (reducer)
+    {
+        double counts[3] = { total_samples, total_loss_count, (double)failed };
+
+        if (reducer->allreduce(reducer->ctx, counts, 3) != 0)
+        {
+            fprintf(stderr, "Gradient reduction failed.\n");
+            failed = 1;
+        }
+        else
         {
+            total_samples = counts[0];
+            total_loss_count = counts[1];
+            failed = counts[2] > 0;
+        }
+    }
 
-            double z = model->bias;
+    if (failed || total_samples < 1)
+    {
+        block_reducer_free(grad_reducer);
+        block_reducer_free(loss_reducer);
+        step_rule_free(step);
+        scaler_free(owned_scaler);
+        free(loss_rows);
+        free(dw);
+        return -1;
+    }
 
-            for (size_t j = 0; j < model->num_features; j++)
-            {
-                z += model->weights[j] *
-                     X[i * model->num_features + j];
-            }
+    LogregPass pass = { model, data, loss_rows };
+    LogregLossEval loss_eval = { grad_reducer, { model, data, NULL }, reducer, total_samples };
 
-            double p = sigmoid(z);
-            double err = p - y[i];
+    size_t patience = config->patience ? config->patience : 1;
+    size_t stalled_checks = 0;
+    int status = 0;
 
-            for (size_t j = 0; j < model->num_features; j++)
-            {
-                dw[j] += err *
-                         X[i * model->num_features + j];
-            }
+    model->trained = 0;
+    model->stopping_iteration = config->num_iterations;
 
-            db += err;
-        }
+    ML_STATS_START(train_start);
+    ML_STATS_HW_BEGIN(hw);
+    ML_STATS_COUNT(ML_STAT_TRAIN_CALLS, 1);
 
-        for (size_t j = 0; j < model->num_features; j++)
+    for (size_t iter = 0; iter < config->num_iterations; iter++)
+    {
+        // A stop request or failed pass is still reduced, flagged, so every
+        // rank leaves the loop at the same iteration
+        int stop = config->should_stop && config->should_stop(config->stop_ctx);
+
+        ML_STATS_COUNT(ML_STAT_ITERATIONS, 1);
+        ML_STATS_COUNT(ML_STAT_ROWS_PROCESSED, num_samples);
+        ML_STATS_START(gradient_start);
+
+        dw[d + 1] = stop || block_reducer_run(grad_reducer, d + 1, logreg_gradient_block,
+                                              &pass, dw) != 0;
+
+        if (reducer && reducer->allreduce(reducer->ctx, dw, d + 2) != 0)
         {
-            dw[j] /= num_samples;
-            model->weights[j] -= config->learning_rate * dw[j];
+            fprintf(stderr, "Gradient reduction failed.\n");
+            ML_STATS_STOP(ML_STAT_GRADIENT_NS, gradient_start);
+            status = -1;
+            break;
         }
 
-        db /= num_samples;
-        model->bias -= config->learning_rate * db;
+        if (dw[d + 1] > 0)
+        {
+            ML_STATS_STOP(ML_STAT_GRADIENT_NS, gradient_start);
+            status = -1;
+            break;
+        }
 
-        double total_loss = 0.0;
+        ML_STATS_STOP(ML_STAT_GRADIENT_NS, gradient_start);
+        ML_STATS_START(update_start);
 
-        for (size_t i = 0; i < num_samples; i++)
+        if (step_rule_update(step, model, dw, total_samples, logreg_mean_loss, &loss_eval) != 0)
         {
+            ML_STATS_STOP(ML_STAT_UPDATE_NS, update_start);
+            status = -1;
+            break;
+        }
 
-            double z = model->bias;
+        model->stopping_iteration = iter + 1;
 
-            for (size_t j = 0; j < model->num_features; j++)
-            {
-                z += model->weights[j] *
-                     X[i * model->num_features + j];
-            }
+        ML_STATS_STOP(ML_STAT_UPDATE_NS, update_start);
+
+        if (!is_loss_check(iter, config->loss_check_interval))
+            continue;
 
-            double p = sigmoid(z);
-            total_loss += binary_cross_entropy(p, y[i]);
+        ML_STATS_START(loss_start);
+
+        // loss followed by a failure flag, reduced together like the gradient
+        double loss[2] = { 0.0, 0.0 };
+
+        loss[1] = block_reducer_run(loss_reducer, 1, logreg_loss_block, &pass, loss) != 0;
+
+        if (reducer && reducer->allreduce(reducer->ctx, loss, 2) != 0)
+        {
+            fprintf(stderr, "Gradient reduction failed.\n");
+            ML_STATS_STOP(ML_STAT_LOSS_NS, loss_start);
+            status = -1;
+            break;
         }
 
-        double avg_loss = total_loss / num_samples;
+        if (loss[1] > 0)
+        {
+            ML_STATS_STOP(ML_STAT_LOSS_NS, loss_start);
+            status = -1;
+            break;
+        }
+
+        double avg_loss = loss[0] / total_loss_count
+                        + step_rule_penalty(step, model);
+
+        ML_STATS_STOP(ML_STAT_LOSS_NS, loss_start);
 
         if (prev_loss > 0 && fabs(prev_loss - avg_loss) / prev_loss < config->early_stopping_threshold)
         {
-            model->stopping_iteration = iter + 1;
-            break;
+            if (++stalled_checks >= patience)
+                break;
+        }
+        else
+        {
+            stalled_checks = 0;
         }
 
         prev_loss = avg_loss;
-        model->stopping_iteration = iter + 1;
     }
 
+    ML_STATS_HW_END(hw);
+    ML_STATS_STOP(ML_STAT_TRAIN_NS, train_start);
+
+    step_rule_finish(step, model);
+    step_rule_free(step);
+    block_reducer_free(grad_reducer);
+    block_reducer_free(loss_reducer);
+    scaler_free(owned_scaler);
+    free(loss_rows);
     free(dw);
+
+    if (status != 0)
+        return status;
+
     model->trained = 1;
     return 0;
 }
@@ -167,4 +396,137 @@ double logreg_predict(const RegressionModel *model, const double *x)
     }
 
     return sigmoid(z);
-}
\ No newline at end of file
+}
+
+int logreg_predict_view(const RegressionModel *model, const DatasetView *data, double *out)
+{
+    if (!model || !model->trained)
+    {
+        fprintf(stderr, "Model is not trained.\n");
+        return -1;
+    }
+
+    if (!data || !data->X || !out || data->num_features != model->num_features)
+        return -1;
+
+    for (size_t i = 0; i < data->num_rows; i++)
+    {
+        const double *row = view_row(data, i);
+        double z = model->bias;
+
+        for (size_t j = 0; j < model->num_features; j++)
+        {
+            z += model->weights[j] * row[j];
+        }
+
+        out[i] = sigmoid(z);
+    }
+
+    return 0;
+}
+
+// Smallest logit whose sigmoid rounds to 1.0 (about 36.7), found by
+// bisection over doubles since it depends on how exp() rounds
+static double logit_of_one(void)
+{
+    double lo = 0.0;
+    double hi = 64.0;
+
+    for (;;)
+    {
+        double mid = lo + (hi - lo) / 2;
+        if (mid <= lo || mid >= hi) break;
+
+        if (sigmoid(mid) >= 1.0)
+            hi = mid;
+        else
+            lo = mid;
+    }
+
+    return hi;
+}
+
+double logreg_logit_threshold(double threshold)
+{
+    if (isnan(threshold))
+        return NAN;
+    if (threshold <= 0.0)
+        return -INFINITY;
+    if (threshold > 1.0)
+        return INFINITY;
+
+    // sigmoid() saturates at 1.0 for large logits, so p >= 1 holds there
+    if (threshold == 1.0)
+        return logit_of_one();
+
+    return log(threshold / (1.0 - threshold));
+}
+
+int logreg_classify(const RegressionModel *model, const double *x, double logit_threshold)
+{
+    if (!x)
+    {
+        fprintf(stderr, "Null pointer passed to logreg_classify.\n");
+        return -1;
+    }
+
+    if (!model || !model->trained)
+    {
+        fprintf(stderr, "Model is not trained.\n");
+        return -1;
+    }
+
+    double z = model->bias;
+
+    for (size_t j = 0; j < model->num_features; j++)
+    {
+        z += model->weights[j] * x[j];
+    }
+
+    return z >= logit_threshold;
+}
+
+int logreg_classify_view(const RegressionModel *model, const DatasetView *data,
+                         double logit_threshold, uint64_t *mask, size_t *num_positive)
+{
+    if (!model || !model->trained)
+    {
+        fprintf(stderr, "Model is not trained.\n");
+        return -1;
+    }
+
+    if (!data || !data->X || !mask || data->num_features != model->num_features)
+        return -1;
+
+    size_t positive = 0;
+
+    // One word per 64 rows; the comparison result is shifted in, no branches
+    for (size_t base = 0; base < data->num_rows; base += 64)
+    {
+        size_t count = data->num_rows - base < 64 ? data->num_rows - base : 64;
+        uint64_t bits = 0;
+
+        for (size_t k = 0; k < count; k++)
+        {
+            const double *row = view_row(data, base + k);
+            double z = model->bias;
+
+            for (size_t j = 0; j < model->num_features; j++)
+            {
+                z += model->weights[j] * row[j];
+            }
+
+            bits |= (uint64_t)(z >= logit_threshold) << k;
+        }
+
+        mask[base / 64] = bits;
+
+        for (uint64_t w = bits; w; w &= w - 1)
+            positive++;
+    }
+
+    if (num_positive)
+        *num_positive = positive;
+
+    return 0;
+}
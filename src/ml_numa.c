@@ -0,0 +1,236 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "ml_numa.h"
+#include "block_reduce.h"
+#include "thread_pool.h"
+
+#if defined(__linux__)
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#define NODE_SYSFS "/sys/devices/system/node"
+
+// From <linux/mempolicy.h>, which is not always installed
+#define ML_MPOL_PREFERRED 1
+
+// Kernel node ids accepted in an mbind node mask
+#define ML_NUMA_MAX_OS_ID 1024
+#endif
+
+typedef struct
+{
+    size_t num_nodes;
+#if defined(__linux__)
+    int os_id[ML_NUMA_MAX_NODES];         // kernel node id of each library node
+    cpu_set_t cpus[ML_NUMA_MAX_NODES];
+#endif
+} NumaTopology;
+
+static NumaTopology topology;
+static pthread_once_t topology_once = PTHREAD_ONCE_INIT;
+
+#if defined(__linux__)
+static int read_line(const char *path, char *buf, size_t size)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+
+    int ok = fgets(buf, (int)size, f) != NULL;
+    fclose(f);
+    return ok ? 0 : -1;
+}
+
+/*
+ * Parses a kernel list such as "0-3,8,10-11", calling fn for every id.
+ */
+static void parse_list(const char *s, void (*fn)(void *ctx, long id), void *ctx)
+{
+    while (*s)
+    {
+        char *end;
+        long lo = strtol(s, &end, 10);
+        if (end == s) break;
+
+        long hi = lo;
+        s = end;
+
+        if (*s == '-')
+        {
+            hi = strtol(s + 1, &end, 10);
+            if (end == s + 1) break;
+            s = end;
+        }
+
+        for (long id = lo; id <= hi; id++)
+            fn(ctx, id);
+
+        if (*s != ',') break;
+        s++;
+    }
+}
+
+static void add_node(void *ctx, long id)
+{
+    (void)ctx;
+
+    if (id >= 0 && id < ML_NUMA_MAX_OS_ID && topology.num_nodes < ML_NUMA_MAX_NODES)
+        topology.os_id[topology.num_nodes++] = (int)id;
+}
+
+static void add_cpu(void *ctx, long cpu)
+{
+    if (cpu >= 0 && cpu < CPU_SETSIZE)
+        CPU_SET((int)cpu, (cpu_set_t *)ctx);
+}
+#endif
+
+static void topology_init(void)
+{
+    topology.num_nodes = 0;
+
+#if defined(__linux__)
+    char buf[4096];
+
+    if (read_line(NODE_SYSFS "/has_cpu", buf, sizeof(buf)) == 0 ||
+        read_line(NODE_SYSFS "/online", buf, sizeof(buf)) == 0)
+        parse_list(buf, add_node, NULL);
+
+    for (size_t n = 0; n < topology.num_nodes; n++)
+    {
+        char path[128];
+        snprintf(path, sizeof(path), NODE_SYSFS "/node%d/cpulist", topology.os_id[n]);
+
+        CPU_ZERO(&topology.cpus[n]);
+        if (read_line(path, buf, sizeof(buf)) == 0)
+            parse_list(buf, add_cpu, &topology.cpus[n]);
+    }
+#endif
+
+    if (topology.num_nodes == 0)
+        topology.num_nodes = 1;
+}
+
+size_t ml_numa_num_nodes(void)
+{
+    pthread_once(&topology_once, topology_init);
+    return topology.num_nodes;
+}
+
+size_t ml_numa_node_cpus(size_t node)
+{
+    if (node >= ml_numa_num_nodes())
+        return 0;
+
+#if defined(__linux__)
+    if (topology.num_nodes > 1)
+        return (size_t)CPU_COUNT(&topology.cpus[node]);
+#endif
+
+    long n = 1;
+#if !defined(_WIN32)
+    n = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return n > 0 ? (size_t)n : 1;
+}
+
+int ml_numa_pin_current(size_t node)
+{
+    if (node >= ml_numa_num_nodes())
+        return -1;
+
+#if defined(__linux__)
+    // One node spans the whole machine: leave the scheduler alone
+    if (topology.num_nodes == 1 || CPU_COUNT(&topology.cpus[node]) == 0)
+        return 0;
+
+    return sched_setaffinity(0, sizeof(cpu_set_t), &topology.cpus[node]) == 0 ? 0 : -1;
+#else
+    return -1;
+#endif
+}
+
+void ml_numa_split(size_t num_rows, size_t num_nodes, size_t node,
+                   size_t *begin, size_t *end)
+{
+    if (num_nodes == 0) num_nodes = 1;
+
+    size_t blocks = (num_rows + ML_REDUCE_BLOCK_ROWS - 1) / ML_REDUCE_BLOCK_ROWS;
+    size_t first = blocks * node / num_nodes;
+    size_t last = blocks * (node + 1) / num_nodes;
+
+    *begin = first * ML_REDUCE_BLOCK_ROWS;
+    *end = last * ML_REDUCE_BLOCK_ROWS;
+
+    if (*begin > num_rows) *begin = num_rows;
+    if (*end > num_rows || node + 1 >= num_nodes) *end = num_rows;
+}
+
+typedef struct
+{
+    unsigned char *base;
+    size_t row_bytes;
+    size_t num_rows;
+    size_t num_nodes;
+} FirstTouch;
+
+static void first_touch_node(void *ctx, size_t node)
+{
+    const FirstTouch *t = ctx;
+    size_t begin, end;
+
+    ml_numa_split(t->num_rows, t->num_nodes, node, &begin, &end);
+    memset(t->base + begin * t->row_bytes, 0, (end - begin) * t->row_bytes);
+}
+
+int ml_numa_place(void *base, size_t row_bytes, size_t num_rows)
+{
+    size_t nodes = ml_numa_num_nodes();
+
+    if (!base || nodes < 2 || row_bytes == 0 || num_rows == 0)
+        return 0;
+
+#if defined(__linux__) && defined(SYS_mbind)
+    uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t start = (uintptr_t)base;
+    int bound = 1;
+
+    for (size_t n = 0; n < nodes && bound; n++)
+    {
+        size_t begin, end;
+        ml_numa_split(num_rows, nodes, n, &begin, &end);
+
+        // Boundary pages go to the node owning their first byte
+        uintptr_t lo = start + begin * row_bytes;
+        uintptr_t hi = start + end * row_bytes;
+        lo = n == 0 ? lo & ~(page - 1) : (lo + page - 1) & ~(page - 1);
+        hi = (hi + page - 1) & ~(page - 1);
+
+        if (hi <= lo) continue;
+
+        unsigned long mask[ML_NUMA_MAX_OS_ID / (8 * sizeof(unsigned long))] = {0};
+        size_t bits = 8 * sizeof(unsigned long);
+        int id = topology.os_id[n];
+
+        mask[id / bits] |= 1UL << (id % bits);
+
+        if (syscall(SYS_mbind, (void *)lo, (unsigned long)(hi - lo), ML_MPOL_PREFERRED,
+                    mask, (unsigned long)(sizeof(mask) * 8 + 1), 0UL) != 0)
+            bound = 0;
+    }
+
+    if (bound)
+        return 0;
+#endif
+
+    // No memory policy support: the page owner is whoever writes it first
+    FirstTouch touch = { base, row_bytes, num_rows, nodes };
+    return thread_pool_run_on_nodes(nodes, first_touch_node, &touch);
+}
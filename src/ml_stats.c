@@ -0,0 +1,197 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <string.h>
+#include "ml_stats.h"
+
+#ifndef ML_ENABLE_STATS
+
+void ml_stats_get(MLStats *out)
+{
+    if (out) memset(out, 0, sizeof(*out));
+}
+
+void ml_stats_reset(void)
+{
+}
+
+int ml_stats_enable_hw_counters(int enable)
+{
+    (void)enable;
+    return -1;
+}
+
+#else
+
+#include <stdatomic.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+static atomic_uint_fast64_t counters[ML_STAT_COUNT];
+
+// Monotonic, so wall-clock adjustments never show up in the timers
+uint64_t ml_stats_clock_ns(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER freq, now;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+
+    // Whole seconds first, so the tick count times 1e9 cannot overflow
+    uint64_t ticks = (uint64_t)now.QuadPart;
+    uint64_t hz = (uint64_t)freq.QuadPart;
+    return ticks / hz * 1000000000ull + ticks % hz * 1000000000ull / hz;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+void ml_stats_add(MLStatCounter counter, uint64_t value)
+{
+    atomic_fetch_add_explicit(&counters[counter], value, memory_order_relaxed);
+}
+
+static uint64_t load(MLStatCounter counter)
+{
+    return atomic_load_explicit(&counters[counter], memory_order_relaxed);
+}
+
+static double seconds(MLStatCounter counter)
+{
+    return load(counter) / 1e9;
+}
+
+void ml_stats_get(MLStats *out)
+{
+    if (!out) return;
+
+    out->load_seconds = seconds(ML_STAT_LOAD_NS);
+    out->bytes_parsed = load(ML_STAT_BYTES_PARSED);
+    out->rows_parsed = load(ML_STAT_ROWS_PARSED);
+
+    out->train_seconds = seconds(ML_STAT_TRAIN_NS);
+    out->train_calls = load(ML_STAT_TRAIN_CALLS);
+    out->iterations = load(ML_STAT_ITERATIONS);
+    out->rows_processed = load(ML_STAT_ROWS_PROCESSED);
+    out->gradient_seconds = seconds(ML_STAT_GRADIENT_NS);
+    out->loss_seconds = seconds(ML_STAT_LOSS_NS);
+    out->update_seconds = seconds(ML_STAT_UPDATE_NS);
+
+    out->predict_seconds = seconds(ML_STAT_PREDICT_NS);
+    out->predict_calls = load(ML_STAT_PREDICT_CALLS);
+    out->rows_predicted = load(ML_STAT_ROWS_PREDICTED);
+
+    out->cycles = load(ML_STAT_HW_CYCLES);
+    out->instructions = load(ML_STAT_HW_INSTRUCTIONS);
+    out->cache_misses = load(ML_STAT_HW_CACHE_MISSES);
+    out->hw_counters = (out->cycles || out->instructions || out->cache_misses);
+}
+
+void ml_stats_reset(void)
+{
+    for (int c = 0; c < ML_STAT_COUNT; c++)
+        atomic_store_explicit(&counters[c], 0, memory_order_relaxed);
+}
+
+#ifdef __linux__
+
+static atomic_int hw_enabled;
+
+static const struct
+{
+    uint64_t config;
+    MLStatCounter counter;
+} hw_events[3] = {
+    { PERF_COUNT_HW_CPU_CYCLES, ML_STAT_HW_CYCLES },
+    { PERF_COUNT_HW_INSTRUCTIONS, ML_STAT_HW_INSTRUCTIONS },
+    { PERF_COUNT_HW_CACHE_MISSES, ML_STAT_HW_CACHE_MISSES },
+};
+
+int ml_stats_enable_hw_counters(int enable)
+{
+    atomic_store(&hw_enabled, enable != 0);
+    return 0;
+}
+
+void ml_stats_hw_begin(MLHwCounters *hw)
+{
+    for (int e = 0; e < 3; e++)
+        hw->fds[e] = -1;
+
+    if (!atomic_load(&hw_enabled)) return;
+
+    // Counts only the calling thread, user space only
+    for (int e = 0; e < 3; e++)
+    {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = hw_events[e].config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        hw->fds[e] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+
+        if (hw->fds[e] >= 0)
+        {
+            ioctl(hw->fds[e], PERF_EVENT_IOC_RESET, 0);
+            ioctl(hw->fds[e], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+void ml_stats_hw_end(MLHwCounters *hw)
+{
+    for (int e = 0; e < 3; e++)
+    {
+        if (hw->fds[e] < 0) continue;
+
+        uint64_t value = 0;
+        ioctl(hw->fds[e], PERF_EVENT_IOC_DISABLE, 0);
+
+        if (read(hw->fds[e], &value, sizeof(value)) == (ssize_t)sizeof(value))
+            ml_stats_add(hw_events[e].counter, value);
+
+        close(hw->fds[e]);
+        hw->fds[e] = -1;
+    }
+}
+
+#else
+
+int ml_stats_enable_hw_counters(int enable)
+{
+    (void)enable;
+    return -1;
+}
+
+void ml_stats_hw_begin(MLHwCounters *hw)
+{
+    for (int e = 0; e < 3; e++)
+        hw->fds[e] = -1;
+}
+
+void ml_stats_hw_end(MLHwCounters *hw)
+{
+    (void)hw;
+}
+
+#endif
+
+#endif
@@ -1,5 +1,7 @@
 #include "mllib.h"
 #include <stdlib.h>
+#include <math.h>
+#include "ml_stats.h"
 
 /*
  * Internal structure definition
@@ -71,6 +73,90 @@ int ml_train(MLModel *model,
     }
 }
 
+/*
+ * Train on a view
+ */
+int ml_train_view(MLModel *model,
+                  const DatasetView *data,
+                  const RegressionConfig *config)
+{
+    return ml_train_reduced(model, data, config, NULL);
+}
+
+/*
+ * Train on a shard with gradient reduction
+ */
+int ml_train_reduced(MLModel *model,
+                     const DatasetView *data,
+                     const RegressionConfig *config,
+                     const GradientReducer *reducer)
+{
+    if (!model || !model->model) return -1;
+
+    switch (model->type)
+    {
+        case ML_LINEAR:
+            return linreg_train_reduced((RegressionModel *)model->model,
+                                        data, config, reducer);
+
+        case ML_LOGISTIC:
+            return logreg_train_reduced((RegressionModel *)model->model,
+                                        data, config, reducer);
+
+        default:
+            return -1;
+    }
+}
+
+/*
+ * Train on sparse rows
+ */
+int ml_train_sparse(MLModel *model,
+                    const SparseDataset *data,
+                    const RegressionConfig *config)
+{
+    if (!model || !model->model) return -1;
+
+    switch (model->type)
+    {
+        case ML_LINEAR:
+            return linreg_train_sparse((RegressionModel *)model->model, data, config);
+
+        case ML_LOGISTIC:
+            return logreg_train_sparse((RegressionModel *)model->model, data, config);
+
+        default:
+            return -1;
+    }
+}
+
+/*
+ * Predict one sparse row
+ */
+double ml_predict_sparse(const MLModel *model,
+                         const uint32_t *idx,
+                         const double *val,
+                         size_t nnz)
+{
+    if (!model || !model->model || (nnz > 0 && (!idx || !val))) return NAN;
+
+    const RegressionModel *m = model->model;
+
+    if (!m->trained) return NAN;
+
+    for (size_t k = 0; k < nnz; k++)
+    {
+        if (idx[k] >= m->num_features) return NAN;
+    }
+
+    double z = sparse_dot(m, idx, val, nnz);
+
+    ML_STATS_COUNT(ML_STAT_PREDICT_CALLS, 1);
+    ML_STATS_COUNT(ML_STAT_ROWS_PREDICTED, 1);
+
+    return model->type == ML_LOGISTIC ? sigmoid(z) : z;
+}
+
 /*
  * Predict
  */
@@ -79,17 +165,113 @@ double ml_predict(const MLModel *model,
 {
     if (!model || !model->model) return 0.0;
 
+    double result;
+
+    ML_STATS_START(predict_start);
+
     switch (model->type)
     {
         case ML_LINEAR:
-            return linreg_predict((RegressionModel *)model->model, x);
+            result = linreg_predict((RegressionModel *)model->model, x);
+            break;
 
         case ML_LOGISTIC:
-            return logreg_predict((RegressionModel *)model->model, x);
+            result = logreg_predict((RegressionModel *)model->model, x);
+            break;
 
         default:
             return 0.0;
     }
+
+    ML_STATS_STOP(ML_STAT_PREDICT_NS, predict_start);
+    ML_STATS_COUNT(ML_STAT_PREDICT_CALLS, 1);
+    ML_STATS_COUNT(ML_STAT_ROWS_PREDICTED, 1);
+
+    return result;
+}
+
+/*
+ * Batch predict over a view
+ */
+int ml_predict_view(const MLModel *model,
+                    const DatasetView *data,
+                    double *out)
+{
+    if (!model || !model->model) return -1;
+
+    int status;
+
+    ML_STATS_START(predict_start);
+
+    switch (model->type)
+    {
+        case ML_LINEAR:
+            status = linreg_predict_view((RegressionModel *)model->model, data, out);
+            break;
+
+        case ML_LOGISTIC:
+            status = logreg_predict_view((RegressionModel *)model->model, data, out);
+            break;
+
+        default:
+            return -1;
+    }
+
+    ML_STATS_STOP(ML_STAT_PREDICT_NS, predict_start);
+    ML_STATS_COUNT(ML_STAT_PREDICT_CALLS, 1);
+    ML_STATS_COUNT(ML_STAT_ROWS_PREDICTED, status == 0 ? data->num_rows : 0);
+
+    return status;
+}
+
+/*
+ * Thresholded class decisions (logistic models only)
+ */
+int ml_classify(const MLModel *model,
+                const double *x,
+                double logit_threshold)
+{
+    if (!model || !model->model || model->type != ML_LOGISTIC) return -1;
+
+    ML_STATS_START(predict_start);
+
+    int result = logreg_classify((RegressionModel *)model->model, x, logit_threshold);
+
+    ML_STATS_STOP(ML_STAT_PREDICT_NS, predict_start);
+    ML_STATS_COUNT(ML_STAT_PREDICT_CALLS, 1);
+    ML_STATS_COUNT(ML_STAT_ROWS_PREDICTED, 1);
+
+    return result;
+}
+
+int ml_classify_view(const MLModel *model,
+                     const DatasetView *data,
+                     double logit_threshold,
+                     uint64_t *mask,
+                     size_t *num_positive)
+{
+    if (!model || !model->model || model->type != ML_LOGISTIC) return -1;
+
+    ML_STATS_START(predict_start);
+
+    int status = logreg_classify_view((RegressionModel *)model->model, data,
+                                      logit_threshold, mask, num_positive);
+
+    ML_STATS_STOP(ML_STAT_PREDICT_NS, predict_start);
+    ML_STATS_COUNT(ML_STAT_PREDICT_CALLS, 1);
+    ML_STATS_COUNT(ML_STAT_ROWS_PREDICTED, status == 0 ? data->num_rows : 0);
+
+    return status;
+}
+
+/*
+ * Feature count
+ */
+size_t ml_num_features(const MLModel *model)
+{
+    if (!model) return 0;
+
+    return model->num_features;
 }
 
 /*
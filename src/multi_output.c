@@ -0,0 +1,372 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "multi_output.h"
+#include "block_reduce.h"
+#include "utils.h"
+#include "ml_stats.h"
+
+// Rows per tile; a tile's residuals (rows x T) stay in cache while W and
+// the gradient are streamed once for the whole tile
+#define MULTI_TILE_ROWS 32
+
+MultiRegressionModel *multireg_create(size_t num_features, size_t num_targets)
+{
+    if (num_targets == 0 || (num_features && num_targets > SIZE_MAX / sizeof(double) / num_features))
+        return NULL;
+
+    MultiRegressionModel *model = malloc(sizeof(MultiRegressionModel));
+    if (!model)
+        return NULL;
+
+    model->weights = calloc(num_features * num_targets, sizeof(double));
+    model->bias = calloc(num_targets, sizeof(double));
+
+    if (!model->weights || !model->bias)
+    {
+        free(model->weights);
+        free(model->bias);
+        free(model);
+        return NULL;
+    }
+
+    model->num_features = num_features;
+    model->num_targets = num_targets;
+    model->stopping_iteration = 0;
+    model->trained = 0;
+
+    return model;
+}
+
+void multireg_free(MultiRegressionModel *model)
+{
+    if (!model)
+        return;
+
+    model->trained = 0;
+    free(model->weights);
+    free(model->bias);
+    free(model);
+}
+
+// y += a * x over the targets of one row
+static inline void axpy(double *restrict y, double a, const double *restrict x, size_t n)
+{
+    for (size_t t = 0; t < n; t++)
+    {
+        y[t] += a * x[t];
+    }
+}
+
+// Residual tile of one kernel call; kept on a free list for the whole
+// train call, so each worker allocates at most one
+typedef struct MultiTile
+{
+    struct MultiTile *next;
+    double E[];
+} MultiTile;
+
+typedef struct
+{
+    const MultiRegressionModel *model;
+    const DatasetView *data;
+    const double *Y;
+    atomic_int failed;
+    pthread_mutex_t lock;
+    MultiTile *free_tiles;
+} MultiPass;
+
+static MultiTile *multireg_tile_acquire(MultiPass *pass)
+{
+    pthread_mutex_lock(&pass->lock);
+    MultiTile *tile = pass->free_tiles;
+    if (tile) pass->free_tiles = tile->next;
+    pthread_mutex_unlock(&pass->lock);
+
+    if (!tile)
+        tile = malloc(sizeof(MultiTile) + MULTI_TILE_ROWS * pass->model->num_targets * sizeof(double));
+
+    return tile;
+}
+
+static void multireg_tile_release(MultiPass *pass, MultiTile *tile)
+{
+    pthread_mutex_lock(&pass->lock);
+    tile->next = pass->free_tiles;
+    pass->free_tiles = tile;
+    pthread_mutex_unlock(&pass->lock);
+}
+
+// partial = [dW (d x T), db (T), loss] over rows [begin, end)
+static void multireg_gradient_block(void *ctx, size_t begin, size_t end, double *partial)
+{
+    MultiPass *pass = ctx;
+    const MultiRegressionModel *model = pass->model;
+    size_t d = model->num_features;
+    size_t T = model->num_targets;
+
+    double *dW = partial;
+    double *db = partial + d * T;
+    double *loss = db + T;
+
+    MultiTile *scratch = multireg_tile_acquire(pass);
+    if (!scratch)
+    {
+        atomic_store(&pass->failed, 1);
+        return;
+    }
+
+    double *E = scratch->E;
+
+    for (size_t tile = begin; tile < end; tile += MULTI_TILE_ROWS)
+    {
+        size_t tile_end = tile + MULTI_TILE_ROWS < end ? tile + MULTI_TILE_ROWS : end;
+
+        // E = X_tile * W + b - Y_tile
+        for (size_t i = tile; i < tile_end; i++)
+        {
+            const double *row = view_row(pass->data, i);
+            const double *y = &pass->Y[view_base_row(pass->data, i) * T];
+            double *e = &E[(i - tile) * T];
+
+            memcpy(e, model->bias, T * sizeof(double));
+
+            for (size_t j = 0; j < d; j++)
+            {
+                axpy(e, row[j], &model->weights[j * T], T);
+            }
+
+            double sq = 0.0;
+
+            for (size_t t = 0; t < T; t++)
+            {
+                e[t] -= y[t];
+                sq += e[t] * e[t];
+            }
+
+            axpy(db, 1.0, e, T);
+            *loss += sq;
+        }
+
+        // dW += X_tile^T * E
+        for (size_t i = tile; i < tile_end; i++)
+        {
+            const double *row = view_row(pass->data, i);
+            const double *e = &E[(i - tile) * T];
+
+            for (size_t j = 0; j < d; j++)
+            {
+                axpy(&dW[j * T], row[j], e, T);
+            }
+        }
+    }
+
+    multireg_tile_release(pass, scratch);
+}
+
+int multireg_train(MultiRegressionModel *model, const double *X, const double *Y,
+                   size_t num_samples, const RegressionConfig *config)
+{
+    if (!model || !X || !Y)
+        return -1;
+
+    DatasetView data = view_create(X, NULL, num_samples, model->num_features);
+    return multireg_train_view(model, &data, Y, config);
+}
+
+int multireg_train_view(MultiRegressionModel *model, const DatasetView *data, const double *Y,
+                        const RegressionConfig *config)
+{
+    if (!model || !data || !data->X || !Y)
+    {
+        fprintf(stderr, "Null pointer passed to multireg_train.\n");
+        return -1;
+    }
+
+    if (data->num_rows < 2)
+    {
+        fprintf(stderr, "Error: Need at least 2 data points for regression.\n");
+        return -1;
+    }
+
+    if (data->num_features != model->num_features)
+    {
+        fprintf(stderr, "Model weights not initialized properly.\n");
+        return -1;
+    }
+
+    if (!config)
+    {
+        fprintf(stderr, "Null config passed.\n");
+        return -1;
+    }
+
+    if (config->solver != REG_SOLVER_GD || config->step_rule != REG_STEP_FIXED || config->standardize)
+    {
+        fprintf(stderr, "Multi-output regression supports only unstandardized fixed-step gradient descent.\n");
+        return -1;
+    }
+
+    size_t d = model->num_features;
+    size_t T = model->num_targets;
+    size_t num_weights = d * T;
+    size_t width = num_weights + T + 1;
+    double n = (double)data->num_rows;
+
+    double *grad = malloc(width * sizeof(double));
+    BlockReducer *rows = block_reducer_create(data->num_rows, width, config->num_threads,
+                                              config->reproducible, config->numa);
+
+    if (!grad || !rows)
+    {
+        fprintf(stderr, "Memory Allocation failed.\n");
+        free(grad);
+        block_reducer_free(rows);
+        return -1;
+    }
+
+    MultiPass pass = { model, data, Y, 0, PTHREAD_MUTEX_INITIALIZER, NULL };
+
+    size_t patience = config->patience ? config->patience : 1;
+    size_t stalled_checks = 0;
+    double prev_loss = DBL_MAX;
+    int status = 0;
+
+    model->trained = 0;
+    model->stopping_iteration = config->num_iterations;
+
+    ML_STATS_START(train_start);
+    ML_STATS_COUNT(ML_STAT_TRAIN_CALLS, 1);
+
+    for (size_t iter = 0; iter < config->num_iterations; iter++)
+    {
+        if (config->should_stop && config->should_stop(config->stop_ctx))
+        {
+            status = -1;
+            break;
+        }
+
+        ML_STATS_COUNT(ML_STAT_ITERATIONS, 1);
+        ML_STATS_COUNT(ML_STAT_ROWS_PROCESSED, data->num_rows);
+        ML_STATS_START(gradient_start);
+
+        if (block_reducer_run(rows, width, multireg_gradient_block, &pass, grad) != 0 ||
+            atomic_load(&pass.failed))
+        {
+            fprintf(stderr, "Memory Allocation failed.\n");
+            ML_STATS_STOP(ML_STAT_GRADIENT_NS, gradient_start);
+            status = -1;
+            break;
+        }
+
+        ML_STATS_STOP(ML_STAT_GRADIENT_NS, gradient_start);
+
+        if (is_loss_check(iter, config->loss_check_interval))
+        {
+            double curr_loss = grad[width - 1] / (2 * n * (double)T)
+                             + penalty_value(model->weights, num_weights,
+                                             config->l1_penalty, config->l2_penalty);
+
+            if (prev_loss > 0 && fabs(prev_loss - curr_loss) / prev_loss < config->early_stopping_threshold)
+            {
+                if (++stalled_checks >= patience)
+                {
+                    model->stopping_iteration = iter;
+                    break;
+                }
+            }
+            else
+            {
+                stalled_checks = 0;
+            }
+
+            prev_loss = curr_loss;
+        }
+
+        ML_STATS_START(update_start);
+
+        for (size_t k = 0; k < num_weights; k++)
+        {
+            model->weights[k] -= config->learning_rate * (grad[k] / n);
+        }
+
+        apply_penalty_step(model->weights, num_weights, config->learning_rate,
+                           config->l1_penalty, config->l2_penalty);
+
+        for (size_t t = 0; t < T; t++)
+        {
+            model->bias[t] -= config->learning_rate * (grad[num_weights + t] / n);
+        }
+
+        ML_STATS_STOP(ML_STAT_UPDATE_NS, update_start);
+    }
+
+    ML_STATS_STOP(ML_STAT_TRAIN_NS, train_start);
+
+    while (pass.free_tiles)
+    {
+        MultiTile *next = pass.free_tiles->next;
+        free(pass.free_tiles);
+        pass.free_tiles = next;
+    }
+
+    pthread_mutex_destroy(&pass.lock);
+    block_reducer_free(rows);
+    free(grad);
+
+    if (status != 0)
+        return status;
+
+    model->trained = 1;
+    return 0;
+}
+
+static void multireg_predict_row(const MultiRegressionModel *model, const double *x, double *out)
+{
+    size_t T = model->num_targets;
+
+    memcpy(out, model->bias, T * sizeof(double));
+
+    for (size_t j = 0; j < model->num_features; j++)
+    {
+        axpy(out, x[j], &model->weights[j * T], T);
+    }
+}
+
+int multireg_predict(const MultiRegressionModel *model, const double *x, double *out)
+{
+    if (!model || !model->trained)
+    {
+        fprintf(stderr, "Model not trained.\n");
+        return -1;
+    }
+
+    if (!x || !out)
+        return -1;
+
+    multireg_predict_row(model, x, out);
+    return 0;
+}
+
+int multireg_predict_view(const MultiRegressionModel *model, const DatasetView *data, double *out)
+{
+    if (!model || !model->trained)
+    {
+        fprintf(stderr, "Model not trained.\n");
+        return -1;
+    }
+
+    if (!data || !data->X || !out || data->num_features != model->num_features)
+        return -1;
+
+    for (size_t i = 0; i < data->num_rows; i++)
+    {
+        multireg_predict_row(model, view_row(data, i), &out[i * model->num_targets]);
+    }
+
+    return 0;
+}
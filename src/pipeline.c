@@ -0,0 +1,244 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "pipeline.h"
+#include "csv_loader.h"
+#include "utils.h"
+
+// Rows read past a full block to tell whether only one row remains
+#define PIPELINE_LOOKAHEAD 2
+
+/*
+ * One half of the double buffer
+ */
+typedef struct
+{
+    double *X;
+    double *y;
+    size_t rows;
+    int full;   // 1 once the producer has filled it, 0 once consumed
+} PipelineSlot;
+
+typedef struct
+{
+    CsvReader reader;
+    PipelineSlot slots[2];
+    size_t block_rows;   // slots hold one more, for a carried single-row tail
+    double *ahead_X;     // rows read ahead, which start the next block
+    double *ahead_y;
+    size_t ahead_rows;
+    int eof;      // producer reached end of file
+    int abort;    // consumer failed, producer should stop
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+} Pipeline;
+
+/*
+ * Fills a slot with the rows read ahead plus a fresh block, then reads
+ * ahead again. A single row left at the end of the file joins this block,
+ * so no block the trainer sees is a lone row (unless the file is one).
+ */
+static size_t pipeline_fill(Pipeline *p, PipelineSlot *slot)
+{
+    size_t features = p->reader.features;
+    size_t rows = p->ahead_rows;
+
+    memcpy(slot->X, p->ahead_X, rows * features * sizeof(double));
+    memcpy(slot->y, p->ahead_y, rows * sizeof(double));
+
+    rows += csv_read_block(&p->reader, &slot->X[rows * features], &slot->y[rows],
+                           p->block_rows - rows);
+
+    p->ahead_rows = rows < p->block_rows ? 0
+                  : csv_read_block(&p->reader, p->ahead_X, p->ahead_y, PIPELINE_LOOKAHEAD);
+
+    if (p->ahead_rows == 1)
+    {
+        memcpy(&slot->X[rows * features], p->ahead_X, features * sizeof(double));
+        slot->y[rows] = p->ahead_y[0];
+        rows++;
+        p->ahead_rows = 0;
+    }
+
+    return rows;
+}
+
+/*
+ * Producer: parses blocks into whichever slot the trainer has released
+ */
+static void *pipeline_producer(void *arg)
+{
+    Pipeline *p = arg;
+    int next = 0;
+
+    for (;;)
+    {
+        PipelineSlot *slot = &p->slots[next];
+
+        pthread_mutex_lock(&p->lock);
+        while (slot->full && !p->abort)
+            pthread_cond_wait(&p->cond, &p->lock);
+        int stop = p->abort;
+        pthread_mutex_unlock(&p->lock);
+
+        if (stop) break;
+
+        size_t rows = pipeline_fill(p, slot);
+
+        pthread_mutex_lock(&p->lock);
+        if (rows == 0)
+        {
+            p->eof = 1;
+        }
+        else
+        {
+            slot->rows = rows;
+            slot->full = 1;
+        }
+        pthread_cond_broadcast(&p->cond);
+        pthread_mutex_unlock(&p->lock);
+
+        if (rows == 0) break;
+
+        next ^= 1;
+    }
+
+    return NULL;
+}
+
+static void pipeline_free_slots(Pipeline *p)
+{
+    for (int s = 0; s < 2; s++)
+    {
+        ml_aligned_free(p->slots[s].X);
+        ml_aligned_free(p->slots[s].y);
+    }
+
+    free(p->ahead_X);
+    free(p->ahead_y);
+}
+
+int ml_train_pipelined(MLModel *model,
+                       const char *filename,
+                       size_t block_rows,
+                       size_t steps_per_block,
+                       const RegressionConfig *config)
+{
+    if (!model || !filename || !config || block_rows < PIPELINE_LOOKAHEAD || steps_per_block == 0)
+    {
+        fprintf(stderr, "Invalid arguments passed to ml_train_pipelined.\n");
+        return -1;
+    }
+
+    // Each block would refit the scaler to its own rows, so the weights
+    // learnt on earlier blocks would be in a different scale
+    if (config->standardize)
+    {
+        fprintf(stderr, "Pipelined training does not support standardize.\n");
+        return -1;
+    }
+
+    Pipeline p = {0};
+    p.block_rows = block_rows;
+
+    if (!csv_reader_open(&p.reader, filename))
+    {
+        fprintf(stderr, "Failed to open %s.\n", filename);
+        return -1;
+    }
+
+    if (p.reader.features != ml_num_features(model))
+    {
+        fprintf(stderr, "Feature count mismatch: file has %zu, model expects %zu.\n",
+                p.reader.features, ml_num_features(model));
+        csv_reader_close(&p.reader);
+        return -1;
+    }
+
+    size_t features = p.reader.features;
+
+    for (int s = 0; s < 2; s++)
+    {
+        p.slots[s].X = ml_aligned_alloc((block_rows + 1) * features * sizeof(double), 0);
+        p.slots[s].y = ml_aligned_alloc((block_rows + 1) * sizeof(double), 0);
+    }
+
+    p.ahead_X = malloc(PIPELINE_LOOKAHEAD * (features ? features : 1) * sizeof(double));
+    p.ahead_y = malloc(PIPELINE_LOOKAHEAD * sizeof(double));
+
+    if (!p.slots[0].X || !p.slots[0].y || !p.slots[1].X || !p.slots[1].y ||
+        !p.ahead_X || !p.ahead_y)
+    {
+        fprintf(stderr, "Memory Allocation failed.\n");
+        pipeline_free_slots(&p);
+        csv_reader_close(&p.reader);
+        return -1;
+    }
+
+    // Each block gets a bounded number of steps, continuing from the
+    // weights the previous block left behind
+    RegressionConfig block_config = *config;
+    block_config.num_iterations = steps_per_block;
+
+    pthread_mutex_init(&p.lock, NULL);
+    pthread_cond_init(&p.cond, NULL);
+
+    pthread_t producer;
+    if (pthread_create(&producer, NULL, pipeline_producer, &p) != 0)
+    {
+        fprintf(stderr, "Failed to start parser thread.\n");
+        pthread_mutex_destroy(&p.lock);
+        pthread_cond_destroy(&p.cond);
+        pipeline_free_slots(&p);
+        csv_reader_close(&p.reader);
+        return -1;
+    }
+
+    int status = 0;
+    int curr = 0;
+    size_t blocks_trained = 0;
+
+    for (;;)
+    {
+        PipelineSlot *slot = &p.slots[curr];
+
+        pthread_mutex_lock(&p.lock);
+        while (!slot->full && !p.eof)
+            pthread_cond_wait(&p.cond, &p.lock);
+        int done = !slot->full;
+        pthread_mutex_unlock(&p.lock);
+
+        if (done) break;
+
+        if (ml_train(model, slot->X, slot->y, slot->rows, &block_config) != 0)
+            status = -1;
+        else
+            blocks_trained++;
+
+        pthread_mutex_lock(&p.lock);
+        slot->full = 0;
+        if (status != 0) p.abort = 1;
+        pthread_cond_broadcast(&p.cond);
+        pthread_mutex_unlock(&p.lock);
+
+        if (status != 0) break;
+
+        curr ^= 1;
+    }
+
+    pthread_join(producer, NULL);
+
+    pthread_mutex_destroy(&p.lock);
+    pthread_cond_destroy(&p.cond);
+    pipeline_free_slots(&p);
+    csv_reader_close(&p.reader);
+
+    if (status == 0 && blocks_trained == 0)
+    {
+        fprintf(stderr, "No data rows in %s.\n", filename);
+        return -1;
+    }
+
+    return status;
+}
@@ -0,0 +1,193 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <stdbool.h>
+#include "sparse_dataset.h"
+#include "utils.h"
+#include "ml_stats.h"
+
+double sparse_dot(const RegressionModel *model, const uint32_t *idx, const double *val, size_t nnz)
+{
+    double z = model->bias;
+
+    for (size_t k = 0; k < nnz; k++)
+    {
+        z += model->weights[idx[k]] * val[k];
+    }
+
+    return z;
+}
+
+static int sparse_train(RegressionModel *model, const SparseDataset *data,
+                        const RegressionConfig *config, bool logistic)
+{
+    if (!model || !data || !data->row_ptr || !data->y || !model->weights)
+    {
+        fprintf(stderr, "Null pointer passed to sparse training.\n");
+        return -1;
+    }
+
+    if (data->rows < 2 || data->num_features != model->num_features)
+    {
+        fprintf(stderr, "Sparse dataset does not match the model.\n");
+        return -1;
+    }
+
+    if (!config)
+    {
+        fprintf(stderr, "Null config passed.\n");
+        return -1;
+    }
+
+    // Centering would turn every implicit zero into a stored value
+    if (config->standardize)
+    {
+        fprintf(stderr, "Sparse training does not support standardize.\n");
+        return -1;
+    }
+
+    if (config->solver != REG_SOLVER_GD || config->step_rule != REG_STEP_FIXED ||
+        config->num_threads > 1 || config->reproducible || config->numa ||
+        config->loss_sample_size > 0)
+    {
+        fprintf(stderr, "Sparse training supports only single-threaded fixed-step gradient descent "
+                        "with a full-pass loss.\n");
+        return -1;
+    }
+
+    size_t d = model->num_features;
+    double n = (double)data->rows;
+
+    double *dw = calloc(d, sizeof(double));
+    if (!dw)
+    {
+        fprintf(stderr, "Memory Allocation failed.\n");
+        return -1;
+    }
+
+    size_t patience = config->patience ? config->patience : 1;
+    size_t stalled_checks = 0;
+    double prev_loss = DBL_MAX;
+
+    model->trained = 0;
+    model->stopping_iteration = config->num_iterations;
+
+    ML_STATS_START(train_start);
+    ML_STATS_COUNT(ML_STAT_TRAIN_CALLS, 1);
+
+    int status = 0;
+
+    for (size_t iter = 0; iter < config->num_iterations; iter++)
+    {
+        if (config->should_stop && config->should_stop(config->stop_ctx))
+        {
+            status = -1;
+            break;
+        }
+
+        memset(dw, 0, d * sizeof(double));
+        double db = 0.0;
+        double loss = 0.0;
+        bool check = is_loss_check(iter, config->loss_check_interval);
+
+        ML_STATS_COUNT(ML_STAT_ITERATIONS, 1);
+        ML_STATS_COUNT(ML_STAT_ROWS_PROCESSED, data->rows);
+        ML_STATS_START(gradient_start);
+
+        for (size_t i = 0; i < data->rows; i++)
+        {
+            size_t begin = data->row_ptr[i];
+            size_t nnz = data->row_ptr[i + 1] - begin;
+            const uint32_t *idx = &data->col_idx[begin];
+            const double *val = &data->values[begin];
+
+            double z = sparse_dot(model, idx, val, nnz);
+            double pred = logistic ? sigmoid(z) : z;
+            double err = pred - data->y[i];
+
+            for (size_t k = 0; k < nnz; k++)
+            {
+                dw[idx[k]] += err * val[k];
+            }
+
+            db += err;
+
+            if (check)
+                loss += logistic ? binary_cross_entropy(pred, data->y[i]) : err * err;
+        }
+
+        ML_STATS_STOP(ML_STAT_GRADIENT_NS, gradient_start);
+
+        if (check)
+        {
+            double curr_loss = (logistic ? loss / n : loss / (2 * n))
+                             + penalty_value(model->weights, d, config->l1_penalty, config->l2_penalty);
+
+            if (prev_loss > 0 && fabs(prev_loss - curr_loss) / prev_loss < config->early_stopping_threshold)
+            {
+                if (++stalled_checks >= patience)
+                {
+                    model->stopping_iteration = iter;
+                    break;
+                }
+            }
+            else
+            {
+                stalled_checks = 0;
+            }
+
+            prev_loss = curr_loss;
+        }
+
+        ML_STATS_START(update_start);
+
+        for (size_t j = 0; j < d; j++)
+        {
+            model->weights[j] -= config->learning_rate * (dw[j] / n);
+        }
+
+        apply_penalty_step(model->weights, d, config->learning_rate,
+                           config->l1_penalty, config->l2_penalty);
+
+        model->bias -= config->learning_rate * (db / n);
+
+        ML_STATS_STOP(ML_STAT_UPDATE_NS, update_start);
+    }
+
+    ML_STATS_STOP(ML_STAT_TRAIN_NS, train_start);
+
+    free(dw);
+
+    if (status != 0)
+        return status;
+
+    model->trained = 1;
+    return 0;
+}
+
+int linreg_train_sparse(RegressionModel *model, const SparseDataset *data, const RegressionConfig *config)
+{
+    return sparse_train(model, data, config, false);
+}
+
+int logreg_train_sparse(RegressionModel *model, const SparseDataset *data, const RegressionConfig *config)
+{
+    return sparse_train(model, data, config, true);
+}
+
+void free_sparse_dataset(SparseDataset *data)
+{
+    if (!data) return;
+
+    free(data->row_ptr);
+    free(data->col_idx);
+    free(data->values);
+    free(data->y);
+
+    data->row_ptr = NULL;
+    data->col_idx = NULL;
+    data->values = NULL;
+    data->y = NULL;
+}
@@ -0,0 +1,345 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "step_rule.h"
+#include "utils.h"
+
+// Armijo: halvings tried before giving up on a step, and growth of the
+// starting trial step after an accepted one
+#define ARMIJO_MAX_HALVINGS 50
+#define ARMIJO_GROWTH 2.0
+
+// Barzilai-Borwein steps are clamped to this many times the base rate
+#define BB_MAX_RATIO 1e8
+#define BB_MIN_RATIO 1e-8
+
+struct StepRule
+{
+    RegressionStepRule kind;
+    size_t dim;              // num_features + 1 (bias last)
+    double learning_rate;
+    double l1_penalty;
+    double l2_penalty;
+    double step;             // current step (BB, Armijo)
+    double loss;             // Armijo: loss at the current params, NAN if unknown
+    double *prev_params;     // BB: previous iterate; Nesterov: last iterate; Armijo: params before the trial
+    double *prev_grad;       // BB: previous mean gradient
+    size_t k;                // Nesterov: iterations since the last restart; BB: step count
+    int has_prev;
+    const FeatureScaler *scaler;
+    RegressionModel scaled;  // params in standardized space when scaler is set
+};
+
+// The parameters the rule optimizes: the model itself, or its standardized twin
+static RegressionModel *rule_params(StepRule *rule, RegressionModel *model)
+{
+    return rule->scaler ? &rule->scaled : model;
+}
+
+// Folds standardized params back into raw-feature weights:
+//   w_j = w'_j / std_j,  b = b' - sum_j w_j * mean_j
+static void publish(const StepRule *rule, RegressionModel *model)
+{
+    if (!rule->scaler)
+        return;
+
+    double bias = rule->scaled.bias;
+
+    for (size_t j = 0; j < model->num_features; j++)
+    {
+        model->weights[j] = rule->scaled.weights[j] * scaler_inv_std(rule->scaler, j);
+        bias -= model->weights[j] * rule->scaler->mean[j];
+    }
+
+    model->bias = bias;
+}
+
+static void get_params(const RegressionModel *model, double *out)
+{
+    memcpy(out, model->weights, model->num_features * sizeof(double));
+    out[model->num_features] = model->bias;
+}
+
+static void set_params(RegressionModel *model, const double *in)
+{
+    memcpy(model->weights, in, model->num_features * sizeof(double));
+    model->bias = in[model->num_features];
+}
+
+// One proximal gradient step of size step from the model's current params
+static void take_step(const StepRule *rule, RegressionModel *model, const double *grad, double step)
+{
+    size_t d = model->num_features;
+
+    for (size_t j = 0; j < d; j++)
+    {
+        model->weights[j] -= step * grad[j];
+    }
+
+    apply_penalty_step(model->weights, d, step, rule->l1_penalty, rule->l2_penalty);
+
+    model->bias -= step * grad[d];
+}
+
+StepRule *step_rule_create(const RegressionModel *model, const RegressionConfig *config,
+                           const FeatureScaler *scaler)
+{
+    if (!model || !config || (scaler && scaler->num_features != model->num_features))
+        return NULL;
+
+    StepRule *rule = calloc(1, sizeof(StepRule));
+    if (!rule)
+        return NULL;
+
+    rule->kind = config->step_rule;
+    rule->dim = model->num_features + 1;
+    rule->learning_rate = config->learning_rate;
+    rule->l1_penalty = config->l1_penalty;
+    rule->l2_penalty = config->l2_penalty;
+    rule->step = config->learning_rate;
+    rule->loss = NAN;
+
+    if (scaler)
+    {
+        size_t d = model->num_features;
+
+        rule->scaler = scaler;
+        rule->scaled.num_features = d;
+        rule->scaled.weights = malloc((d ? d : 1) * sizeof(double));
+
+        if (!rule->scaled.weights)
+        {
+            step_rule_free(rule);
+            return NULL;
+        }
+
+        // Warm start: express the current weights in standardized space
+        rule->scaled.bias = model->bias;
+
+        for (size_t j = 0; j < d; j++)
+        {
+            rule->scaled.weights[j] = model->weights[j] / scaler_inv_std(scaler, j);
+            rule->scaled.bias += model->weights[j] * scaler->mean[j];
+        }
+    }
+
+    if (rule->kind != REG_STEP_FIXED)
+    {
+        rule->prev_params = malloc(rule->dim * sizeof(double));
+        rule->prev_grad = malloc(rule->dim * sizeof(double));
+
+        if (!rule->prev_params || !rule->prev_grad)
+        {
+            step_rule_free(rule);
+            return NULL;
+        }
+
+        get_params(rule_params(rule, (RegressionModel *)model), rule->prev_params);
+    }
+
+    return rule;
+}
+
+static void barzilai_borwein(StepRule *rule, RegressionModel *model, const double *grad)
+{
+    size_t d = model->num_features;
+
+    if (rule->has_prev)
+    {
+        // s = change in params, y = change in gradient. Alternate the long
+        // (s.s / s.y) and short (s.y / y.y) steps, which keeps the fast
+        // progress of the long step without its blow-ups on non-quadratic losses.
+        double ss = 0.0;
+        double sy = 0.0;
+        double yy = 0.0;
+
+        for (size_t j = 0; j <= d; j++)
+        {
+            double param = j < d ? model->weights[j] : model->bias;
+            double s = param - rule->prev_params[j];
+            double y = grad[j] - rule->prev_grad[j];
+
+            ss += s * s;
+            sy += s * y;
+            yy += y * y;
+        }
+
+        double step = (rule->k++ % 2 == 0) ? ss / sy : sy / yy;
+
+        // Non-positive curvature along s: keep the previous step
+        if (sy > 0.0 && isfinite(step))
+        {
+            double max_step = BB_MAX_RATIO * rule->learning_rate;
+            double min_step = BB_MIN_RATIO * rule->learning_rate;
+
+            rule->step = fmin(fmax(step, min_step), max_step);
+        }
+    }
+
+    get_params(model, rule->prev_params);
+    memcpy(rule->prev_grad, grad, rule->dim * sizeof(double));
+    rule->has_prev = 1;
+
+    take_step(rule, model, grad, rule->step);
+}
+
+// The model holds the extrapolated point y_k; prev_params holds x_k
+static void nesterov(StepRule *rule, RegressionModel *model, const double *grad)
+{
+    size_t d = model->num_features;
+
+    take_step(rule, model, grad, rule->learning_rate);
+
+    // Adaptive restart: drop the momentum once it points uphill
+    double uphill = 0.0;
+    for (size_t j = 0; j <= d; j++)
+    {
+        double param = j < d ? model->weights[j] : model->bias;
+        uphill += grad[j] * (param - rule->prev_params[j]);
+    }
+
+    if (uphill > 0.0)
+        rule->k = 0;
+
+    double beta = (double)rule->k / (double)(rule->k + 3);
+    rule->k++;
+
+    for (size_t j = 0; j < d; j++)
+    {
+        double x = model->weights[j];
+        model->weights[j] = x + beta * (x - rule->prev_params[j]);
+        rule->prev_params[j] = x;
+    }
+
+    double x = model->bias;
+    model->bias = x + beta * (x - rule->prev_params[d]);
+    rule->prev_params[d] = x;
+}
+
+// Backtracking on the proximal sufficient-decrease condition
+//   f(x+) <= f(x) + g.(x+ - x) + |x+ - x|^2 / (2 t)
+static int armijo(StepRule *rule, RegressionModel *model, RegressionModel *params,
+                  const double *grad, StepLossFn loss_fn, void *ctx)
+{
+    size_t d = model->num_features;
+
+    if (!loss_fn)
+        return -1;
+
+    if (isnan(rule->loss))
+    {
+        rule->loss = loss_fn(ctx);
+        if (isnan(rule->loss))
+            return -1;
+    }
+
+    get_params(params, rule->prev_params);
+
+    double step = rule->step;
+
+    for (int attempt = 0; attempt <= ARMIJO_MAX_HALVINGS; attempt++)
+    {
+        take_step(rule, params, grad, step);
+        publish(rule, model);
+
+        double trial_loss = loss_fn(ctx);
+        if (isnan(trial_loss))
+            return -1;
+
+        double linear = 0.0;
+        double quad = 0.0;
+
+        for (size_t j = 0; j <= d; j++)
+        {
+            double param = j < d ? params->weights[j] : params->bias;
+            double diff = param - rule->prev_params[j];
+
+            linear += grad[j] * diff;
+            quad += diff * diff;
+        }
+
+        if (trial_loss <= rule->loss + linear + quad / (2.0 * step) ||
+            attempt == ARMIJO_MAX_HALVINGS)
+        {
+            rule->loss = trial_loss;
+            rule->step = step * ARMIJO_GROWTH;
+            return 0;
+        }
+
+        set_params(params, rule->prev_params);
+        step *= 0.5;
+    }
+
+    return 0;
+}
+
+int step_rule_update(StepRule *rule, RegressionModel *model, double *grad, double scale,
+                     StepLossFn loss_fn, void *ctx)
+{
+    size_t d = model->num_features;
+    RegressionModel *params = rule_params(rule, model);
+    int status = 0;
+
+    for (size_t j = 0; j < rule->dim; j++)
+    {
+        grad[j] /= scale;
+    }
+
+    // Chain rule through x'_j = (x_j - mean_j) / std_j
+    if (rule->scaler)
+    {
+        for (size_t j = 0; j < d; j++)
+        {
+            grad[j] = (grad[j] - rule->scaler->mean[j] * grad[d]) * scaler_inv_std(rule->scaler, j);
+        }
+    }
+
+    switch (rule->kind)
+    {
+    case REG_STEP_ARMIJO:
+        status = armijo(rule, model, params, grad, loss_fn, ctx);
+        break;
+    case REG_STEP_BB:
+        barzilai_borwein(rule, params, grad);
+        break;
+    case REG_STEP_NESTEROV:
+        nesterov(rule, params, grad);
+        break;
+    case REG_STEP_FIXED:
+    default:
+        take_step(rule, params, grad, rule->learning_rate);
+        break;
+    }
+
+    publish(rule, model);
+    return status;
+}
+
+double step_rule_penalty(StepRule *rule, RegressionModel *model)
+{
+    const RegressionModel *params = rule_params(rule, model);
+    return penalty_value(params->weights, params->num_features, rule->l1_penalty, rule->l2_penalty);
+}
+
+void step_rule_finish(StepRule *rule, RegressionModel *model)
+{
+    if (!rule)
+        return;
+
+    if (rule->kind == REG_STEP_NESTEROV)
+        set_params(rule_params(rule, model), rule->prev_params);
+
+    publish(rule, model);
+}
+
+void step_rule_free(StepRule *rule)
+{
+    if (!rule)
+        return;
+
+    free(rule->prev_params);
+    free(rule->prev_grad);
+    free(rule->scaled.weights);
+    free(rule);
+}
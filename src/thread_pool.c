@@ -0,0 +1,536 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "thread_pool.h"
+#include "ml_numa.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+typedef struct PoolTask
+{
+    void (*fn)(void *arg);
+    void *arg;
+    struct PoolTask *next;
+} PoolTask;
+
+/*
+ * Per-worker task deque (ring buffer). The owner pushes and pops at the
+ * back, so nested work runs newest-first while its data is still in
+ * cache; idle workers steal the oldest task from the front.
+ */
+typedef struct
+{
+    pthread_mutex_t lock;
+    PoolTask **tasks;
+    size_t capacity;
+    size_t head;
+    size_t count;
+} WorkerDeque;
+
+typedef struct
+{
+    ThreadPool *pool;
+    size_t index;
+} PoolWorker;
+
+struct ThreadPool
+{
+    pthread_t *threads;
+    size_t num_threads;
+    size_t node;          // NUMA node the workers are pinned to, SIZE_MAX if unpinned
+    PoolWorker *workers;
+    WorkerDeque *deques;  // one per worker
+    size_t num_deques;
+    PoolTask *head;       // tasks submitted from outside the pool
+    PoolTask *tail;
+    atomic_size_t pending; // tasks queued anywhere in the pool
+    size_t sleepers;
+    int shutdown;
+    pthread_mutex_t lock; // external queue, sleeping and shutdown
+    pthread_cond_t cond;
+};
+
+// The worker the current thread is, if it belongs to a pool
+static _Thread_local PoolWorker *current_worker = NULL;
+
+static size_t online_cpus(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (size_t)info.dwNumberOfProcessors : 1;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (size_t)n : 1;
+#endif
+}
+
+static int deque_push(WorkerDeque *dq, PoolTask *task)
+{
+    pthread_mutex_lock(&dq->lock);
+
+    if (dq->count == dq->capacity)
+    {
+        size_t capacity = dq->capacity ? 2 * dq->capacity : 64;
+        PoolTask **tasks = malloc(capacity * sizeof(PoolTask *));
+
+        if (!tasks)
+        {
+            pthread_mutex_unlock(&dq->lock);
+            return -1;
+        }
+
+        for (size_t i = 0; i < dq->count; i++)
+            tasks[i] = dq->tasks[(dq->head + i) % dq->capacity];
+
+        free(dq->tasks);
+        dq->tasks = tasks;
+        dq->capacity = capacity;
+        dq->head = 0;
+    }
+
+    dq->tasks[(dq->head + dq->count) % dq->capacity] = task;
+    dq->count++;
+
+    pthread_mutex_unlock(&dq->lock);
+    return 0;
+}
+
+static PoolTask *deque_pop_back(WorkerDeque *dq)
+{
+    PoolTask *task = NULL;
+
+    pthread_mutex_lock(&dq->lock);
+    if (dq->count > 0)
+    {
+        dq->count--;
+        task = dq->tasks[(dq->head + dq->count) % dq->capacity];
+    }
+    pthread_mutex_unlock(&dq->lock);
+
+    return task;
+}
+
+static PoolTask *deque_steal(WorkerDeque *dq)
+{
+    PoolTask *task = NULL;
+
+    pthread_mutex_lock(&dq->lock);
+    if (dq->count > 0)
+    {
+        task = dq->tasks[dq->head];
+        dq->head = (dq->head + 1) % dq->capacity;
+        dq->count--;
+    }
+    pthread_mutex_unlock(&dq->lock);
+
+    return task;
+}
+
+// Own deque first, then the external queue, then the other workers
+static PoolTask *take_task(ThreadPool *pool, size_t self)
+{
+    PoolTask *task = deque_pop_back(&pool->deques[self]);
+
+    if (!task)
+    {
+        pthread_mutex_lock(&pool->lock);
+        task = pool->head;
+        if (task)
+        {
+            pool->head = task->next;
+            if (!pool->head) pool->tail = NULL;
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+
+    for (size_t k = 1; !task && k < pool->num_deques; k++)
+        task = deque_steal(&pool->deques[(self + k) % pool->num_deques]);
+
+    if (task)
+        atomic_fetch_sub(&pool->pending, 1);
+
+    return task;
+}
+
+static void *pool_worker(void *arg)
+{
+    PoolWorker *worker = arg;
+    ThreadPool *pool = worker->pool;
+
+    current_worker = worker;
+
+    if (pool->node != SIZE_MAX)
+        ml_numa_pin_current(pool->node);
+
+    for (;;)
+    {
+        PoolTask *task = take_task(pool, worker->index);
+
+        if (task)
+        {
+            task->fn(task->arg);
+            free(task);
+            continue;
+        }
+
+        pthread_mutex_lock(&pool->lock);
+        while (atomic_load(&pool->pending) == 0 && !pool->shutdown)
+        {
+            pool->sleepers++;
+            pthread_cond_wait(&pool->cond, &pool->lock);
+            pool->sleepers--;
+        }
+
+        // Shutdown once every queue has drained
+        int done = pool->shutdown && atomic_load(&pool->pending) == 0;
+        pthread_mutex_unlock(&pool->lock);
+
+        if (done)
+            break;
+    }
+
+    return NULL;
+}
+
+static ThreadPool *pool_create(size_t num_threads, size_t node)
+{
+    ThreadPool *pool = calloc(1, sizeof(ThreadPool));
+    if (!pool) return NULL;
+
+    pool->node = node;
+
+    pool->threads = calloc(num_threads, sizeof(pthread_t));
+    pool->workers = calloc(num_threads, sizeof(PoolWorker));
+    pool->deques = calloc(num_threads, sizeof(WorkerDeque));
+    if (!pool->threads || !pool->workers || !pool->deques)
+    {
+        free(pool->threads);
+        free(pool->workers);
+        free(pool->deques);
+        free(pool);
+        return NULL;
+    }
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->cond, NULL);
+    atomic_init(&pool->pending, 0);
+
+    // Every deque exists before any worker starts stealing
+    for (size_t t = 0; t < num_threads; t++)
+    {
+        pthread_mutex_init(&pool->deques[t].lock, NULL);
+        pool->workers[t].pool = pool;
+        pool->workers[t].index = t;
+    }
+    pool->num_deques = num_threads;
+
+    for (size_t t = 0; t < num_threads; t++)
+    {
+        if (pthread_create(&pool->threads[t], NULL, pool_worker, &pool->workers[t]) != 0)
+        {
+            fprintf(stderr, "Failed to start worker thread.\n");
+            pool->num_threads = t;
+            thread_pool_destroy(pool);
+            return NULL;
+        }
+    }
+
+    pool->num_threads = num_threads;
+    return pool;
+}
+
+ThreadPool *thread_pool_create(size_t num_threads)
+{
+    if (num_threads == 0)
+        num_threads = online_cpus();
+
+    return pool_create(num_threads, SIZE_MAX);
+}
+
+static ThreadPool *shared_pool = NULL;
+static pthread_once_t shared_once = PTHREAD_ONCE_INIT;
+
+static void shared_pool_init(void)
+{
+    shared_pool = thread_pool_create(0);
+}
+
+ThreadPool *thread_pool_shared(void)
+{
+    pthread_once(&shared_once, shared_pool_init);
+    return shared_pool;
+}
+
+static ThreadPool *node_pools[ML_NUMA_MAX_NODES];
+static pthread_mutex_t node_pools_lock = PTHREAD_MUTEX_INITIALIZER;
+
+ThreadPool *thread_pool_node(size_t node)
+{
+    if (node >= ml_numa_num_nodes())
+        return NULL;
+
+    pthread_mutex_lock(&node_pools_lock);
+
+    if (!node_pools[node])
+    {
+        size_t cpus = ml_numa_node_cpus(node);
+        node_pools[node] = pool_create(cpus ? cpus : 1, node);
+    }
+
+    ThreadPool *pool = node_pools[node];
+    pthread_mutex_unlock(&node_pools_lock);
+    return pool;
+}
+
+size_t thread_pool_size(const ThreadPool *pool)
+{
+    return pool ? pool->num_threads : 0;
+}
+
+int thread_pool_submit(ThreadPool *pool, void (*fn)(void *arg), void *arg)
+{
+    if (!pool || !fn) return -1;
+
+    PoolTask *task = malloc(sizeof(PoolTask));
+    if (!task) return -1;
+
+    task->fn = fn;
+    task->arg = arg;
+    task->next = NULL;
+
+    // A worker keeps its own subtasks; everyone else feeds the shared queue
+    int local = current_worker && current_worker->pool == pool &&
+                deque_push(&pool->deques[current_worker->index], task) == 0;
+
+    if (local)
+        atomic_fetch_add(&pool->pending, 1);
+
+    pthread_mutex_lock(&pool->lock);
+
+    if (!local)
+    {
+        if (pool->tail)
+            pool->tail->next = task;
+        else
+            pool->head = task;
+        pool->tail = task;
+        atomic_fetch_add(&pool->pending, 1);
+    }
+
+    if (pool->sleepers > 0)
+        pthread_cond_signal(&pool->cond);
+    pthread_mutex_unlock(&pool->lock);
+
+    return 0;
+}
+
+/*
+ * A parallel_for batch. Indices are claimed atomically by the caller and
+ * by helper tasks; helpers that start after all indices are claimed exit
+ * immediately. The batch is reference counted so the caller never waits
+ * for a helper that has not started.
+ */
+typedef struct
+{
+    void (*fn)(void *ctx, size_t index);
+    void *ctx;
+    size_t count;
+    atomic_size_t next;
+    atomic_size_t done;
+    atomic_int refs;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+} PoolBatch;
+
+static void batch_release(PoolBatch *batch)
+{
+    if (atomic_fetch_sub(&batch->refs, 1) == 1)
+    {
+        pthread_mutex_destroy(&batch->lock);
+        pthread_cond_destroy(&batch->cond);
+        free(batch);
+    }
+}
+
+static void batch_run(PoolBatch *batch)
+{
+    size_t i;
+
+    while ((i = atomic_fetch_add(&batch->next, 1)) < batch->count)
+    {
+        batch->fn(batch->ctx, i);
+
+        if (atomic_fetch_add(&batch->done, 1) + 1 == batch->count)
+        {
+            pthread_mutex_lock(&batch->lock);
+            pthread_cond_broadcast(&batch->cond);
+            pthread_mutex_unlock(&batch->lock);
+        }
+    }
+}
+
+static void batch_helper(void *arg)
+{
+    PoolBatch *batch = arg;
+
+    batch_run(batch);
+    batch_release(batch);
+}
+
+int thread_pool_parallel_for(ThreadPool *pool,
+                             size_t count,
+                             void (*fn)(void *ctx, size_t index),
+                             void *ctx)
+{
+    return thread_pool_parallel_for_limit(pool, count, SIZE_MAX, fn, ctx);
+}
+
+int thread_pool_parallel_for_limit(ThreadPool *pool,
+                                   size_t count,
+                                   size_t max_threads,
+                                   void (*fn)(void *ctx, size_t index),
+                                   void *ctx)
+{
+    if (!fn) return -1;
+    if (count == 0) return 0;
+
+    PoolBatch *batch = malloc(sizeof(PoolBatch));
+    if (!batch) return -1;
+
+    batch->fn = fn;
+    batch->ctx = ctx;
+    batch->count = count;
+    atomic_init(&batch->next, 0);
+    atomic_init(&batch->done, 0);
+    atomic_init(&batch->refs, 1);
+    pthread_mutex_init(&batch->lock, NULL);
+    pthread_cond_init(&batch->cond, NULL);
+
+    // One helper per worker, but never more helpers than extra indices
+    size_t helpers = pool ? pool->num_threads : 0;
+    if (helpers > count - 1) helpers = count - 1;
+    if (max_threads > 0 && helpers > max_threads - 1) helpers = max_threads - 1;
+
+    for (size_t h = 0; h < helpers; h++)
+    {
+        atomic_fetch_add(&batch->refs, 1);
+
+        if (thread_pool_submit(pool, batch_helper, batch) != 0)
+        {
+            // The caller simply does more of the work itself
+            atomic_fetch_sub(&batch->refs, 1);
+            break;
+        }
+    }
+
+    batch_run(batch);
+
+    pthread_mutex_lock(&batch->lock);
+    while (atomic_load(&batch->done) < count)
+        pthread_cond_wait(&batch->cond, &batch->lock);
+    pthread_mutex_unlock(&batch->lock);
+
+    batch_release(batch);
+    return 0;
+}
+
+/*
+ * One fn(ctx, node) call per node, each queued on that node's pool. The
+ * batch lives on the caller's stack: a task touches it only under the
+ * lock, and the caller returns only after the last task has signalled.
+ */
+typedef struct
+{
+    void (*fn)(void *ctx, size_t node);
+    void *ctx;
+    size_t count;
+    size_t done;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+} NodeBatch;
+
+typedef struct
+{
+    NodeBatch *batch;
+    size_t node;
+} NodeTask;
+
+static void node_task_run(void *arg)
+{
+    NodeTask *task = arg;
+    NodeBatch *batch = task->batch;
+
+    batch->fn(batch->ctx, task->node);
+
+    pthread_mutex_lock(&batch->lock);
+    if (++batch->done == batch->count)
+        pthread_cond_signal(&batch->cond);
+    pthread_mutex_unlock(&batch->lock);
+}
+
+int thread_pool_run_on_nodes(size_t num_nodes,
+                             void (*fn)(void *ctx, size_t node),
+                             void *ctx)
+{
+    if (!fn) return -1;
+    if (num_nodes == 0) return 0;
+
+    NodeTask *tasks = malloc(num_nodes * sizeof(NodeTask));
+    if (!tasks) return -1;
+
+    NodeBatch batch = { fn, ctx, num_nodes, 0,
+                        PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER };
+
+    for (size_t n = 0; n < num_nodes; n++)
+    {
+        tasks[n].batch = &batch;
+        tasks[n].node = n;
+
+        // Without a pool for the node, the caller runs its share (unpinned)
+        if (thread_pool_submit(thread_pool_node(n), node_task_run, &tasks[n]) != 0)
+            node_task_run(&tasks[n]);
+    }
+
+    pthread_mutex_lock(&batch.lock);
+    while (batch.done < num_nodes)
+        pthread_cond_wait(&batch.cond, &batch.lock);
+    pthread_mutex_unlock(&batch.lock);
+
+    pthread_mutex_destroy(&batch.lock);
+    pthread_cond_destroy(&batch.cond);
+    free(tasks);
+    return 0;
+}
+
+void thread_pool_destroy(ThreadPool *pool)
+{
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->cond);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (size_t t = 0; t < pool->num_threads; t++)
+        pthread_join(pool->threads[t], NULL);
+
+    for (size_t t = 0; t < pool->num_deques; t++)
+    {
+        pthread_mutex_destroy(&pool->deques[t].lock);
+        free(pool->deques[t].tasks);
+    }
+
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->cond);
+    free(pool->deques);
+    free(pool->workers);
+    free(pool->threads);
+    free(pool);
+}
@@ -1,5 +1,15 @@
+#define _DEFAULT_SOURCE
+
 #include <string.h>
 #include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "utils.h"
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#endif
 
 bool has_file_extension(const char *filename, const char *ext)
 {
@@ -7,4 +17,177 @@ bool has_file_extension(const char *filename, const char *ext)
 
     const char *dot = strrchr(filename, '.');
     return (dot && dot != filename && *(dot+1) != '\0' && strcmp(dot+1, ext) == 0);
-}
\ No newline at end of file
+}
+
+/*
+ * Every aligned block is preceded by a header recording how to release it
+ */
+typedef struct
+{
+    void *base;       // start of the underlying allocation
+    size_t map_len;   // length of the mapping, 0 when allocated with malloc
+} AllocHeader;
+
+static void *align_block(void *base, size_t map_len, size_t offset)
+{
+    uintptr_t p = (uintptr_t)base + offset;
+    p = (p + ML_ALIGNMENT - 1) & ~(uintptr_t)(ML_ALIGNMENT - 1);
+
+    AllocHeader *h = (AllocHeader *)p - 1;
+    h->base = base;
+    h->map_len = map_len;
+    return (void *)p;
+}
+
+void *ml_aligned_alloc(size_t bytes, int flags)
+{
+    // Room for the header in front of the aligned block
+    size_t overhead = ML_ALIGNMENT + sizeof(AllocHeader);
+
+    if (bytes > SIZE_MAX - overhead - ML_HUGE_PAGE_SIZE) return NULL;
+
+#if !defined(_WIN32) && defined(MAP_ANONYMOUS)
+    if (bytes >= ML_HUGE_PAGE_SIZE)
+    {
+        size_t len = (bytes + overhead + ML_HUGE_PAGE_SIZE - 1) & ~(ML_HUGE_PAGE_SIZE - 1);
+        void *base = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+        if (flags & ML_ALLOC_HUGE_PAGES)
+            base = mmap(NULL, len, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+        if (base == MAP_FAILED)
+        {
+            base = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#ifdef MADV_HUGEPAGE
+            if (base != MAP_FAILED)
+                madvise(base, len, MADV_HUGEPAGE);
+#endif
+        }
+
+        if (base != MAP_FAILED)
+            return align_block(base, len, sizeof(AllocHeader));
+    }
+#else
+    (void)flags;
+#endif
+
+    void *base = malloc(bytes + overhead);
+    if (!base) return NULL;
+
+    return align_block(base, 0, sizeof(AllocHeader));
+}
+
+void ml_aligned_free(void *ptr)
+{
+    if (!ptr) return;
+
+    AllocHeader *h = (AllocHeader *)ptr - 1;
+
+#if !defined(_WIN32) && defined(MAP_ANONYMOUS)
+    if (h->map_len)
+    {
+        munmap(h->base, h->map_len);
+        return;
+    }
+#endif
+
+    free(h->base);
+}
+
+bool ml_aligned_is_mapped(const void *ptr)
+{
+    return ptr && ((const AllocHeader *)ptr - 1)->map_len != 0;
+}
+
+uint64_t random_init(unsigned int seed)
+{
+    uint64_t state = 0x9E3779B97F4A7C15ULL ^ (uint64_t)seed;
+    return state ? state : 1;
+}
+
+// xorshift64*, so sampling does not depend on the platform's rand()
+uint64_t random_next(uint64_t *state)
+{
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+static int compare_size(const void *a, const void *b)
+{
+    size_t x = *(const size_t *)a;
+    size_t y = *(const size_t *)b;
+    return (x > y) - (x < y);
+}
+
+size_t *sample_indices(size_t n, size_t k, unsigned int seed)
+{
+    if (k > n) k = n;
+
+    size_t *idx = malloc((k ? k : 1) * sizeof(size_t));
+    if (!idx) return NULL;
+
+    uint64_t state = random_init(seed);
+
+    // Reservoir sampling: one pass, O(k) memory
+    for (size_t i = 0; i < k; i++)
+        idx[i] = i;
+
+    for (size_t i = k; i < n; i++)
+    {
+        size_t r = (size_t)(random_next(&state) % (i + 1));
+        if (r < k) idx[r] = i;
+    }
+
+    // Ascending order keeps the evaluation pass streaming through X
+    qsort(idx, k, sizeof(size_t), compare_size);
+    return idx;
+}
+
+bool is_loss_check(size_t iter, size_t interval)
+{
+    if (interval <= 1) return true;
+
+    return (iter + 1) % interval == 0;
+}
+
+double soft_threshold(double x, double t)
+{
+    if (x > t) return x - t;
+    if (x < -t) return x + t;
+    return 0.0;
+}
+
+double penalty_value(const double *w, size_t n, double l1, double l2)
+{
+    if (l1 == 0.0 && l2 == 0.0) return 0.0;
+
+    double abs_sum = 0.0;
+    double sq_sum = 0.0;
+
+    for (size_t j = 0; j < n; j++)
+    {
+        abs_sum += fabs(w[j]);
+        sq_sum += w[j] * w[j];
+    }
+
+    return l1 * abs_sum + 0.5 * l2 * sq_sum;
+}
+
+void apply_penalty_step(double *w, size_t n, double step, double l1, double l2)
+{
+    if (l1 == 0.0 && l2 == 0.0) return;
+
+    // Ridge shrinkage is exact as a proximal step: w / (1 + step * l2)
+    double shrink = 1.0 / (1.0 + step * l2);
+
+    for (size_t j = 0; j < n; j++)
+    {
+        w[j] = soft_threshold(w[j], step * l1) * shrink;
+    }
+}